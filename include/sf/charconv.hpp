@@ -0,0 +1,542 @@
+/**StreamFormat charconv.hpp
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2018-2020 Berrysoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+#ifndef SF_CHARCONV_HPP
+#define SF_CHARCONV_HPP
+
+#include <sf/utility.hpp>
+
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <ostream>
+#include <type_traits>
+#include <vector>
+
+#ifdef SF_HAS_SSE2
+    #include <emmintrin.h>
+    #ifdef _MSC_VER
+        #include <intrin.h>
+    #endif // _MSC_VER
+#endif // SF_HAS_SSE2
+
+namespace sf
+{
+    namespace internal
+    {
+        //Character types, which are not formatted as integers.
+        template <typename T>
+        struct is_char_type : std::bool_constant<std::is_same_v<T, char> || std::is_same_v<T, signed char> || std::is_same_v<T, unsigned char> || std::is_same_v<T, wchar_t> || std::is_same_v<T, char16_t> || std::is_same_v<T, char32_t>
+#ifdef __cpp_char8_t
+                                                 || std::is_same_v<T, char8_t>
+#endif // __cpp_char8_t
+                                                 >
+        {
+        };
+
+        template <typename T>
+        inline constexpr bool is_char_type_v = is_char_type<T>::value;
+
+        template <typename T>
+        inline constexpr bool is_fast_integer_v = std::is_integral_v<T> && !std::is_same_v<T, bool> && !is_char_type_v<T>;
+
+        //A character is written directly only to a stream of its own type, or a narrow character to a char stream.
+        template <typename T, typename Char>
+        inline constexpr bool is_fast_char_v = std::is_same_v<T, Char> || (std::is_same_v<Char, char> && (std::is_same_v<T, signed char> || std::is_same_v<T, unsigned char>));
+
+        //Object pointers are written as addresses, except pointers to characters, which are strings.
+        template <typename T>
+        inline constexpr bool is_fast_pointer_v = std::is_pointer_v<T> && std::is_object_v<std::remove_pointer_t<T>> && !is_char_type_v<std::remove_cv_t<std::remove_pointer_t<T>>>;
+
+        //Floating-point values need std::to_chars for floating-point types.
+        template <typename T>
+        inline constexpr bool is_fast_float_v =
+#ifdef __cpp_lib_to_chars
+            std::is_floating_point_v<T>;
+#else
+            false;
+#endif // __cpp_lib_to_chars
+
+        template <typename T, typename Char>
+        inline constexpr bool is_locale_free_v = is_fast_integer_v<T> || std::is_same_v<T, bool> || is_fast_char_v<T, Char> || is_fast_pointer_v<T> || is_fast_float_v<T>;
+
+        inline constexpr char digit_pairs[] =
+            "00010203040506070809"
+            "10111213141516171819"
+            "20212223242526272829"
+            "30313233343536373839"
+            "40414243444546474849"
+            "50515253545556575859"
+            "60616263646566676869"
+            "70717273747576777879"
+            "80818283848586878889"
+            "90919293949596979899";
+
+        //Write the digits of an unsigned integer backwards, ending at last; returns the first digit.
+        template <typename Char, typename UInt>
+        constexpr Char* format_uint(Char* last, UInt value, unsigned base, bool upper) noexcept
+        {
+            if (base == 10)
+            {
+                while (value >= 100)
+                {
+                    unsigned i = static_cast<unsigned>(value % 100) * 2;
+                    value /= 100;
+                    *--last = static_cast<Char>(digit_pairs[i + 1]);
+                    *--last = static_cast<Char>(digit_pairs[i]);
+                }
+                if (value >= 10)
+                {
+                    unsigned i = static_cast<unsigned>(value) * 2;
+                    *--last = static_cast<Char>(digit_pairs[i + 1]);
+                    *--last = static_cast<Char>(digit_pairs[i]);
+                }
+                else
+                {
+                    *--last = static_cast<Char>('0' + static_cast<unsigned>(value));
+                }
+            }
+            else
+            {
+                const char* digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+                const unsigned shift = base == 16 ? 4 : 3;
+                do
+                {
+                    *--last = static_cast<Char>(digits[static_cast<unsigned>(value) & (base - 1)]);
+                    value >>= shift;
+                } while (value);
+            }
+            return last;
+        }
+
+        //Enough for a 64-bit integer in octal with its prefix.
+        inline constexpr std::size_t integer_buffer_size = 32;
+
+        //Format an integer as num_put does in the classic locale, backwards into the buffer ending at last.
+        //The returned prefix is the count of sign or base characters before which internal padding goes.
+        template <typename Char, typename Int>
+        constexpr Char* format_integer(Char* last, Int value, std::ios_base::fmtflags flags, std::size_t& prefix) noexcept
+        {
+            using unsigned_type = std::make_unsigned_t<Int>;
+            const std::ios_base::fmtflags basefield = flags & std::ios_base::basefield;
+            Char* first = last;
+            prefix = 0;
+            if (basefield == std::ios_base::oct || basefield == std::ios_base::hex)
+            {
+                const bool upper = static_cast<bool>(flags & std::ios_base::uppercase);
+                unsigned_type u = static_cast<unsigned_type>(value);
+                first = format_uint(last, u, basefield == std::ios_base::oct ? 8 : 16, upper);
+                if ((flags & std::ios_base::showbase) && u)
+                {
+                    if (basefield == std::ios_base::oct)
+                    {
+                        *--first = Char{ '0' };
+                    }
+                    else
+                    {
+                        *--first = upper ? Char{ 'X' } : Char{ 'x' };
+                        *--first = Char{ '0' };
+                        prefix = 2;
+                    }
+                }
+            }
+            else
+            {
+                const bool negative = value < 0;
+                unsigned_type u = negative ? static_cast<unsigned_type>(unsigned_type(0) - static_cast<unsigned_type>(value)) : static_cast<unsigned_type>(value);
+                first = format_uint(last, u, 10, false);
+                if (negative)
+                {
+                    *--first = Char{ '-' };
+                    prefix = 1;
+                }
+                else if (std::is_signed_v<Int> && (flags & std::ios_base::showpos))
+                {
+                    *--first = Char{ '+' };
+                    prefix = 1;
+                }
+            }
+            return first;
+        }
+
+        template <typename Char, typename Traits>
+        bool put_fill(std::basic_streambuf<Char, Traits>* buf, Char fill, std::streamsize count)
+        {
+            Char fills[16];
+            for (Char& c : fills)
+                c = fill;
+            while (count > 0)
+            {
+                std::streamsize n = count < 16 ? count : 16;
+                if (buf->sputn(fills, n) != n)
+                    return false;
+                count -= n;
+            }
+            return true;
+        }
+
+        //Write the text with the width, fill and adjustfield of the stream, and reset the width.
+        template <typename Char, typename Traits>
+        void put_padded(std::basic_ostream<Char, Traits>& stream, const Char* str, std::streamsize len, std::size_t prefix)
+        {
+            std::basic_streambuf<Char, Traits>* buf = stream.rdbuf();
+            const std::streamsize width = stream.width();
+            bool ok = true;
+            if (width > len)
+            {
+                const std::ios_base::fmtflags adjust = stream.flags() & std::ios_base::adjustfield;
+                if (adjust == std::ios_base::left)
+                {
+                    ok = buf->sputn(str, len) == len && put_fill(buf, stream.fill(), width - len);
+                }
+                else
+                {
+                    std::streamsize head = adjust == std::ios_base::internal ? static_cast<std::streamsize>(prefix) : 0;
+                    ok = buf->sputn(str, head) == head && put_fill(buf, stream.fill(), width - len) && buf->sputn(str + head, len - head) == len - head;
+                }
+            }
+            else
+            {
+                ok = buf->sputn(str, len) == len;
+            }
+            stream.width(0);
+            if (!ok)
+                stream.setstate(std::ios_base::badbit);
+        }
+
+        template <typename Char, typename Traits, typename Int>
+        std::basic_ostream<Char, Traits>& put_integer(std::basic_ostream<Char, Traits>& stream, Int value, std::ios_base::fmtflags flags)
+        {
+            typename std::basic_ostream<Char, Traits>::sentry ok(stream);
+            if (ok)
+            {
+                Char buffer[integer_buffer_size];
+                std::size_t prefix;
+                Char* first = format_integer(buffer + integer_buffer_size, value, flags, prefix);
+                put_padded(stream, first, buffer + integer_buffer_size - first, prefix);
+            }
+            return stream;
+        }
+
+#ifdef __cpp_lib_to_chars
+        //Exact precision in fixed or scientific notation. The general notation is the shortest
+        //round-trip text, or with shortest unset, "%.*g" as num_put writes it.
+        template <typename Float>
+        std::to_chars_result format_float(char* first, char* last, Float value, std::ios_base::fmtflags floatfield, int precision, bool shortest) noexcept
+        {
+            if (floatfield == std::ios_base::fixed)
+                return std::to_chars(first, last, value, std::chars_format::fixed, precision);
+            else if (floatfield == std::ios_base::scientific)
+                return std::to_chars(first, last, value, std::chars_format::scientific, precision);
+            else if (!shortest)
+                return std::to_chars(first, last, value, std::chars_format::general, precision);
+            else
+                return std::to_chars(first, last, value);
+        }
+
+        //The text of a floating-point number with the notation, showpos and uppercase of the flags.
+        //Hexfloat and showpoint are rare enough to leave them to num_put.
+        class float_chars
+        {
+        private:
+            char local[128];
+            std::vector<char> heap;
+            char* first;
+            char* last;
+
+        public:
+            static bool supports(std::ios_base::fmtflags flags) noexcept
+            {
+                return (flags & std::ios_base::floatfield) != std::ios_base::floatfield && !(flags & std::ios_base::showpoint);
+            }
+
+            template <typename Float>
+            float_chars(Float value, std::ios_base::fmtflags flags, std::streamsize precision, bool shortest)
+            {
+                const std::ios_base::fmtflags floatfield = flags & std::ios_base::floatfield;
+                const int prec = precision < 0 ? 6 : static_cast<int>(precision);
+                //Leave the first character for an explicit plus sign.
+                first = local + 1;
+                std::to_chars_result result = format_float(first, local + sizeof(local), value, floatfield, prec, shortest);
+                for (std::size_t size = 1024; result.ec != std::errc{}; size *= 2)
+                {
+                    heap.resize(size);
+                    first = heap.data() + 1;
+                    result = format_float(first, heap.data() + size, value, floatfield, prec, shortest);
+                }
+                last = result.ptr;
+                if ((flags & std::ios_base::showpos) && *first != '-')
+                    *--first = '+';
+                if (flags & std::ios_base::uppercase)
+                {
+                    for (char* it = first; it != last; ++it)
+                    {
+                        if (*it >= 'a' && *it <= 'z')
+                            *it = static_cast<char>(*it - 'a' + 'A');
+                    }
+                }
+            }
+            float_chars(const float_chars&) = delete;
+            float_chars& operator=(const float_chars&) = delete;
+
+            const char* data() const noexcept { return first; }
+            std::size_t size() const noexcept { return static_cast<std::size_t>(last - first); }
+            //The count of sign characters, before which internal padding goes.
+            std::size_t prefix() const noexcept { return (*first == '-' || *first == '+') ? 1 : 0; }
+        };
+
+        template <typename Char, typename Traits, typename Float>
+        std::basic_ostream<Char, Traits>& put_float(std::basic_ostream<Char, Traits>& stream, Float value)
+        {
+            const std::ios_base::fmtflags flags = stream.flags();
+            if (!float_chars::supports(flags))
+                return stream << value;
+            typename std::basic_ostream<Char, Traits>::sentry ok(stream);
+            if (ok)
+            {
+                const float_chars text(value, flags, stream.precision(), true);
+                const char* first = text.data();
+                const char* last = first + text.size();
+                const std::size_t prefix = text.prefix();
+                if constexpr (std::is_same_v<Char, char>)
+                {
+                    put_padded(stream, first, last - first, prefix);
+                }
+                else
+                {
+                    std::vector<Char> wide(first, last);
+                    put_padded(stream, wide.data(), static_cast<std::streamsize>(wide.size()), prefix);
+                }
+            }
+            return stream;
+        }
+#endif // __cpp_lib_to_chars
+
+        //Write integers, bools, characters and pointers without num_put, byte-identical to the classic locale.
+        //Floating-point values are written by std::to_chars.
+        template <typename Char, typename Traits, typename T>
+        std::basic_ostream<Char, Traits>& put_locale_free(std::basic_ostream<Char, Traits>& stream, T value)
+        {
+            if constexpr (std::is_same_v<T, bool>)
+            {
+                if (stream.flags() & std::ios_base::boolalpha)
+                {
+                    typename std::basic_ostream<Char, Traits>::sentry ok(stream);
+                    if (ok)
+                    {
+                        constexpr Char t[] = { Char{ 't' }, Char{ 'r' }, Char{ 'u' }, Char{ 'e' } };
+                        constexpr Char f[] = { Char{ 'f' }, Char{ 'a' }, Char{ 'l' }, Char{ 's' }, Char{ 'e' } };
+                        if (value)
+                            put_padded(stream, t, 4, 0);
+                        else
+                            put_padded(stream, f, 5, 0);
+                    }
+                    return stream;
+                }
+                return put_integer(stream, static_cast<long>(value), stream.flags());
+            }
+            else if constexpr (is_fast_integer_v<T>)
+            {
+                return put_integer(stream, value, stream.flags());
+            }
+#ifdef __cpp_lib_to_chars
+            else if constexpr (std::is_floating_point_v<T>)
+            {
+                return put_float(stream, value);
+            }
+#endif // __cpp_lib_to_chars
+            else if constexpr (std::is_pointer_v<T>)
+            {
+                using uintptr_type = std::conditional_t<sizeof(const void*) <= sizeof(unsigned long), unsigned long, unsigned long long>;
+                const std::ios_base::fmtflags flags = (stream.flags() & ~(std::ios_base::basefield | std::ios_base::uppercase)) | std::ios_base::hex | std::ios_base::showbase;
+                return put_integer(stream, reinterpret_cast<uintptr_type>(static_cast<const volatile void*>(value)), flags);
+            }
+            else
+            {
+                typename std::basic_ostream<Char, Traits>::sentry ok(stream);
+                if (ok)
+                {
+                    Char c = static_cast<Char>(value);
+                    put_padded(stream, &c, 1, 0);
+                }
+                return stream;
+            }
+        }
+        template <typename Char>
+        constexpr bool is_space(Char c) noexcept
+        {
+            return c == Char{ ' ' } || c == Char{ '\t' } || c == Char{ '\n' } || c == Char{ '\v' } || c == Char{ '\f' } || c == Char{ '\r' };
+        }
+
+#ifdef SF_HAS_SSE2
+        //Parse the leading decimal digits of 16 readable bytes. Returns the count of digits;
+        //value is set only when it is less than 16.
+        inline std::size_t parse_digits16(const char* first, std::uint64_t& value) noexcept
+        {
+            const __m128i digits = _mm_sub_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first)), _mm_set1_epi8('0'));
+            const __m128i is_digit = _mm_and_si128(_mm_cmpgt_epi8(digits, _mm_set1_epi8(-1)), _mm_cmplt_epi8(digits, _mm_set1_epi8(10)));
+            const unsigned mask = ~static_cast<unsigned>(_mm_movemask_epi8(is_digit));
+    #if defined(__GNUC__) || defined(__clang__)
+            const std::size_t len = static_cast<std::size_t>(__builtin_ctz(mask));
+    #else
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            const std::size_t len = index;
+    #endif // __GNUC__ || __clang__
+            if (len == 0 || len == 16)
+                return len;
+            //Shift the digits to the high lanes behind zeros, so that every lane has a fixed weight.
+            const __m128i lanes = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+            const __m128i kept = _mm_and_si128(digits, _mm_cmplt_epi8(lanes, _mm_set1_epi8(static_cast<char>(len))));
+            const __m128i low = _mm_slli_si128(kept, 8);
+            const long long bits = static_cast<long long>(16 - len) * 8;
+            //Counts out of [0, 63] shift to zero.
+            const __m128i x = _mm_or_si128(_mm_or_si128(_mm_sll_epi64(kept, _mm_set_epi64x(0, bits)), _mm_srl_epi64(low, _mm_set_epi64x(0, 64 - bits))), _mm_sll_epi64(low, _mm_set_epi64x(0, bits - 64)));
+            //Combine the digits to pairs, quads and octets with multiply-adds.
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i w10 = _mm_setr_epi16(10, 1, 10, 1, 10, 1, 10, 1);
+            __m128i v = _mm_packs_epi32(_mm_madd_epi16(_mm_unpacklo_epi8(x, zero), w10), _mm_madd_epi16(_mm_unpackhi_epi8(x, zero), w10));
+            v = _mm_madd_epi16(v, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+            v = _mm_packs_epi32(v, v);
+            v = _mm_madd_epi16(v, _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1));
+            value = static_cast<std::uint64_t>(_mm_cvtsi128_si32(v)) * 100000000u + static_cast<std::uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(v, 4)));
+            return len;
+        }
+#endif // SF_HAS_SSE2
+
+        //Parse a number as num_get does in the classic locale, without skipping spaces.
+        //Returns the end of the number, or nullptr if there is no valid number.
+        template <typename Char, typename T>
+        const Char* parse_number(const Char* first, const Char* last, T& value, int base = 10) noexcept
+        {
+            if constexpr (!std::is_same_v<Char, char>)
+            {
+                //Numbers are ASCII, so narrow the leading ASCII characters and parse them.
+                char buffer[128];
+                std::size_t len = 0;
+                for (const Char* it = first; it != last && len < sizeof(buffer); ++it, ++len)
+                {
+                    if (static_cast<std::uint32_t>(*it) >= 0x80)
+                        break;
+                    buffer[len] = static_cast<char>(*it);
+                }
+                const char* end = parse_number(buffer, buffer + len, value, base);
+                return end ? first + (end - buffer) : nullptr;
+            }
+            else
+            {
+                bool negative = false;
+                if (first != last && (*first == '+' || *first == '-'))
+                {
+                    negative = *first == '-';
+                    ++first;
+                    //from_chars rejects a plus sign, and a minus sign for unsigned types.
+                    if (negative && (std::is_floating_point_v<T> || std::is_signed_v<T>))
+                    {
+                        --first;
+                        negative = false;
+                    }
+                }
+                if constexpr (std::is_floating_point_v<T>)
+                {
+#ifdef __cpp_lib_to_chars
+                    auto result = std::from_chars(first, last, value);
+                    if (result.ec != std::errc{})
+                        return nullptr;
+                    return result.ptr;
+#else
+                    char buffer[128];
+                    std::size_t len = static_cast<std::size_t>(last - first) < sizeof(buffer) - 1 ? static_cast<std::size_t>(last - first) : sizeof(buffer) - 1;
+                    std::char_traits<char>::copy(buffer, first, len);
+                    buffer[len] = '\0';
+                    char* end;
+                    long double result = std::strtold(buffer, &end);
+                    if (end == buffer)
+                        return nullptr;
+                    value = static_cast<T>(result);
+                    return first + (end - buffer);
+#endif // __cpp_lib_to_chars
+                }
+                else
+                {
+#ifdef SF_HAS_SSE2
+                    if constexpr (is_fast_integer_v<T>)
+                    {
+                        //Numbers of less than 16 digits, with 16 bytes to load, are parsed in one vector.
+                        const bool minus = std::is_signed_v<T> && first != last && *first == '-';
+                        const char* digits = minus ? first + 1 : first;
+                        std::uint64_t n;
+                        std::size_t len;
+                        if (base == 10 && last - digits >= 16 && (len = parse_digits16(digits, n)) > 0 && len < 16)
+                        {
+                            using unsigned_type = std::make_unsigned_t<T>;
+                            const std::uint64_t limit = static_cast<std::uint64_t>(std::numeric_limits<T>::max()) + (minus ? 1 : 0);
+                            if (n > limit)
+                                return nullptr;
+                            value = static_cast<T>(minus ? static_cast<unsigned_type>(0u - static_cast<unsigned_type>(n)) : static_cast<unsigned_type>(n));
+                            if (negative)
+                                value = static_cast<T>(T(0) - value);
+                            return digits + len;
+                        }
+                    }
+#endif // SF_HAS_SSE2
+                    if (base == 16)
+                    {
+                        //num_get takes the 0x prefix after the sign. Without digits after it, "0x" is
+                        //left to operator>>, which fails.
+                        const bool minus = first != last && *first == '-';
+                        const char* digits = minus ? first + 1 : first;
+                        if (last - digits >= 2 && digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X'))
+                        {
+                            if constexpr (std::is_signed_v<T>)
+                            {
+                                if (minus)
+                                {
+                                    using unsigned_type = std::make_unsigned_t<T>;
+                                    unsigned_type n;
+                                    auto result = std::from_chars(digits + 2, last, n, base);
+                                    if (result.ec != std::errc{} || n > static_cast<unsigned_type>(std::numeric_limits<T>::max()) + 1u)
+                                        return nullptr;
+                                    value = static_cast<T>(static_cast<unsigned_type>(0u - n));
+                                    return result.ptr;
+                                }
+                            }
+                            first = digits + 2;
+                        }
+                    }
+                    auto result = std::from_chars(first, last, value, base);
+                    if (result.ec != std::errc{})
+                        return nullptr;
+                    if (negative)
+                        value = static_cast<T>(T(0) - value);
+                    return result.ptr;
+                }
+            }
+        }
+    } // namespace internal
+} // namespace sf
+
+#endif // !SF_CHARCONV_HPP
@@ -0,0 +1,407 @@
+/**StreamFormat deferred.hpp
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2018-2020 Berrysoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+#ifndef SF_DEFERRED_HPP
+#define SF_DEFERRED_HPP
+
+#include <sf/utility.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <sf/format.hpp>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace sf
+{
+    namespace internal
+    {
+        //Layout of a deferred log file:
+        //  magic "SFDL", version byte
+        //  'F' u32 id, u32 length, format string: defines a format string
+        //  'P' or 'L' u32 id, u8 count, arguments: a print or println record
+        //An argument is a type byte followed by the raw bytes of the value,
+        //or by u32 length and the characters for a string.
+        inline constexpr char deferred_magic[] = { 'S', 'F', 'D', 'L', 1 };
+
+        enum class deferred_type : std::uint8_t
+        {
+            boolean,
+            character,
+            signed_character,
+            unsigned_character,
+            short_integer,
+            unsigned_short_integer,
+            integer,
+            unsigned_integer,
+            long_integer,
+            unsigned_long_integer,
+            long_long_integer,
+            unsigned_long_long_integer,
+            single_float,
+            double_float,
+            long_double_float,
+            pointer,
+            string
+        };
+
+        template <typename T>
+        inline constexpr bool is_deferred_string_v = std::is_convertible_v<const T&, std::string_view>;
+
+        template <typename T>
+        constexpr deferred_type deferred_type_of() noexcept
+        {
+            if constexpr (is_deferred_string_v<T>)
+                return deferred_type::string;
+            else if constexpr (std::is_pointer_v<T>)
+                return deferred_type::pointer;
+            else if constexpr (std::is_same_v<T, bool>)
+                return deferred_type::boolean;
+            else if constexpr (std::is_same_v<T, char>)
+                return deferred_type::character;
+            else if constexpr (std::is_same_v<T, signed char>)
+                return deferred_type::signed_character;
+            else if constexpr (std::is_same_v<T, unsigned char>)
+                return deferred_type::unsigned_character;
+            else if constexpr (std::is_same_v<T, short>)
+                return deferred_type::short_integer;
+            else if constexpr (std::is_same_v<T, unsigned short>)
+                return deferred_type::unsigned_short_integer;
+            else if constexpr (std::is_same_v<T, int>)
+                return deferred_type::integer;
+            else if constexpr (std::is_same_v<T, unsigned int>)
+                return deferred_type::unsigned_integer;
+            else if constexpr (std::is_same_v<T, long>)
+                return deferred_type::long_integer;
+            else if constexpr (std::is_same_v<T, unsigned long>)
+                return deferred_type::unsigned_long_integer;
+            else if constexpr (std::is_same_v<T, long long>)
+                return deferred_type::long_long_integer;
+            else if constexpr (std::is_same_v<T, unsigned long long>)
+                return deferred_type::unsigned_long_long_integer;
+            else if constexpr (std::is_same_v<T, float>)
+                return deferred_type::single_float;
+            else if constexpr (std::is_same_v<T, double>)
+                return deferred_type::double_float;
+            else
+            {
+                static_assert(std::is_same_v<T, long double>, "Deferred arguments should be arithmetic types, pointers or narrow strings.");
+                return deferred_type::long_double_float;
+            }
+        }
+
+        template <typename T>
+        std::size_t deferred_size(const T& arg) noexcept
+        {
+            if constexpr (is_deferred_string_v<T>)
+                return 1 + sizeof(std::uint32_t) + std::string_view(arg).length();
+            else if constexpr (std::is_pointer_v<T>)
+                return 1 + sizeof(const void*);
+            else
+                return 1 + sizeof(T);
+        }
+    } // namespace internal
+
+    //Records print calls in a binary file, to be formatted later by deferred_reader.
+    //A writer is not thread safe; use one writer per thread.
+    class deferred_writer
+    {
+    private:
+        std::FILE* file;
+        std::vector<char> buffer;
+        std::size_t used;
+        std::unordered_map<const char*, std::uint32_t> ids;
+
+        char* reserve(std::size_t size)
+        {
+            if (used + size > buffer.size())
+            {
+                flush();
+                if (size > buffer.size())
+                    buffer.resize(size);
+            }
+            char* result = buffer.data() + used;
+            used += size;
+            return result;
+        }
+
+        template <typename T>
+        static char* put_raw(char* out, const T& value) noexcept
+        {
+            std::memcpy(out, &value, sizeof(T));
+            return out + sizeof(T);
+        }
+
+        template <typename T>
+        static char* put_arg(char* out, const T& arg) noexcept
+        {
+            *out++ = static_cast<char>(internal::deferred_type_of<T>());
+            if constexpr (internal::is_deferred_string_v<T>)
+            {
+                std::string_view str(arg);
+                out = put_raw(out, static_cast<std::uint32_t>(str.length()));
+                std::memcpy(out, str.data(), str.length());
+                return out + str.length();
+            }
+            else if constexpr (std::is_pointer_v<T>)
+            {
+                return put_raw(out, static_cast<const void*>(arg));
+            }
+            else
+            {
+                return put_raw(out, arg);
+            }
+        }
+
+        std::uint32_t format_id(std::string_view fmt)
+        {
+            auto it = ids.find(fmt.data());
+            if (it != ids.end())
+                return it->second;
+            std::uint32_t id = static_cast<std::uint32_t>(ids.size());
+            ids.emplace(fmt.data(), id);
+            char* out = reserve(1 + 2 * sizeof(std::uint32_t) + fmt.length());
+            *out++ = 'F';
+            out = put_raw(out, id);
+            out = put_raw(out, static_cast<std::uint32_t>(fmt.length()));
+            std::memcpy(out, fmt.data(), fmt.length());
+            return id;
+        }
+
+        template <typename... Args>
+        void record(char kind, std::string_view fmt, const Args&... args)
+        {
+            static_assert(sizeof...(Args) < 256, "Too many arguments.");
+            std::uint32_t id = format_id(fmt);
+            char* out = reserve(2 + sizeof(std::uint32_t) + (std::size_t{ 0 } + ... + internal::deferred_size(args)));
+            *out++ = kind;
+            out = put_raw(out, id);
+            *out++ = static_cast<char>(sizeof...(Args));
+            ((out = put_arg(out, args)), ...);
+        }
+
+    public:
+        explicit deferred_writer(const char* path, std::size_t capacity = 65536) : file(std::fopen(path, "wb")), buffer(capacity), used(0)
+        {
+            if (file)
+                std::fwrite(internal::deferred_magic, 1, sizeof(internal::deferred_magic), file);
+        }
+        deferred_writer(const deferred_writer&) = delete;
+        deferred_writer& operator=(const deferred_writer&) = delete;
+        ~deferred_writer()
+        {
+            if (file)
+            {
+                flush();
+                std::fclose(file);
+            }
+        }
+
+        explicit operator bool() const noexcept { return file != nullptr; }
+
+        void flush()
+        {
+            if (file && used)
+                std::fwrite(buffer.data(), 1, used, file);
+            used = 0;
+        }
+
+        //The format string is identified by its address, so it should be a string literal or live as long as the writer.
+        template <typename... Args>
+        void print(std::string_view fmt, const Args&... args)
+        {
+            record('P', fmt, args...);
+        }
+        template <typename... Args>
+        void println(std::string_view fmt, const Args&... args)
+        {
+            record('L', fmt, args...);
+        }
+    };
+
+    //Formats the records of a deferred log file with the normal print engine.
+    class deferred_reader
+    {
+    private:
+        std::vector<char> data;
+        std::vector<std::string> formats;
+        bool valid;
+
+        template <typename T>
+        static bool get_raw(const char*& it, const char* end, T& value) noexcept
+        {
+            if (static_cast<std::size_t>(end - it) < sizeof(T))
+                return false;
+            std::memcpy(&value, it, sizeof(T));
+            it += sizeof(T);
+            return true;
+        }
+
+        template <typename T>
+        static bool get_arg(const char*& it, const char* end, internal::arg_list_t<std::ostream>& args)
+        {
+            T value;
+            if constexpr (std::is_same_v<T, bool>)
+            {
+                //Copying a byte other than 0 or 1 into a bool is undefined, so test the bytes instead.
+                unsigned char bytes[sizeof(bool)];
+                if (!get_raw(it, end, bytes))
+                    return false;
+                value = false;
+                for (unsigned char byte : bytes)
+                    value = value || byte != 0;
+            }
+            else if (!get_raw(it, end, value))
+            {
+                return false;
+            }
+            args.emplace_back(internal::arg_io<internal::output, T, char, std::char_traits<char>>(std::move(value)));
+            return true;
+        }
+
+        static bool get_arg(const char*& it, const char* end, internal::arg_list_t<std::ostream>& args)
+        {
+            if (it == end)
+                return false;
+            switch (static_cast<internal::deferred_type>(*it++))
+            {
+            case internal::deferred_type::boolean:
+                return get_arg<bool>(it, end, args);
+            case internal::deferred_type::character:
+                return get_arg<char>(it, end, args);
+            case internal::deferred_type::signed_character:
+                return get_arg<signed char>(it, end, args);
+            case internal::deferred_type::unsigned_character:
+                return get_arg<unsigned char>(it, end, args);
+            case internal::deferred_type::short_integer:
+                return get_arg<short>(it, end, args);
+            case internal::deferred_type::unsigned_short_integer:
+                return get_arg<unsigned short>(it, end, args);
+            case internal::deferred_type::integer:
+                return get_arg<int>(it, end, args);
+            case internal::deferred_type::unsigned_integer:
+                return get_arg<unsigned int>(it, end, args);
+            case internal::deferred_type::long_integer:
+                return get_arg<long>(it, end, args);
+            case internal::deferred_type::unsigned_long_integer:
+                return get_arg<unsigned long>(it, end, args);
+            case internal::deferred_type::long_long_integer:
+                return get_arg<long long>(it, end, args);
+            case internal::deferred_type::unsigned_long_long_integer:
+                return get_arg<unsigned long long>(it, end, args);
+            case internal::deferred_type::single_float:
+                return get_arg<float>(it, end, args);
+            case internal::deferred_type::double_float:
+                return get_arg<double>(it, end, args);
+            case internal::deferred_type::long_double_float:
+                return get_arg<long double>(it, end, args);
+            case internal::deferred_type::pointer:
+                return get_arg<const void*>(it, end, args);
+            case internal::deferred_type::string:
+            {
+                std::uint32_t length;
+                if (!get_raw(it, end, length) || static_cast<std::size_t>(end - it) < length)
+                    return false;
+                args.emplace_back(internal::arg_io<internal::output, std::string, char, std::char_traits<char>>(std::string(it, length)));
+                it += length;
+                return true;
+            }
+            default:
+                return false;
+            }
+        }
+
+    public:
+        explicit deferred_reader(const char* path) : valid(false)
+        {
+            if (std::FILE* file = std::fopen(path, "rb"))
+            {
+                char block[65536];
+                std::size_t n;
+                while ((n = std::fread(block, 1, sizeof(block), file)) > 0)
+                    data.insert(data.end(), block, block + n);
+                std::fclose(file);
+                valid = data.size() >= sizeof(internal::deferred_magic) && std::memcmp(data.data(), internal::deferred_magic, sizeof(internal::deferred_magic)) == 0;
+            }
+        }
+
+        explicit operator bool() const noexcept { return valid; }
+
+        //Print all records to the stream. Returns false if the file is truncated or corrupted.
+        bool replay(std::ostream& stream)
+        {
+            if (!valid)
+                return false;
+            const char* it = data.data() + sizeof(internal::deferred_magic);
+            const char* end = data.data() + data.size();
+            formats.clear();
+            while (it != end)
+            {
+                char kind = *it++;
+                std::uint32_t id;
+                if (!get_raw(it, end, id))
+                    return false;
+                if (kind == 'F')
+                {
+                    std::uint32_t length;
+                    if (!get_raw(it, end, length) || static_cast<std::size_t>(end - it) < length)
+                        return false;
+                    //Ids are given in order, so any other id is corrupted.
+                    if (id != formats.size())
+                        return false;
+                    formats.emplace_back(it, length);
+                    it += length;
+                }
+                else if (kind == 'P' || kind == 'L')
+                {
+                    if (id >= formats.size() || it == end)
+                        return false;
+                    std::size_t count = static_cast<unsigned char>(*it++);
+                    internal::arg_list_t<std::ostream> args;
+                    args.reserve(count);
+                    for (std::size_t i = 0; i < count; i++)
+                    {
+                        if (!get_arg(it, end, args))
+                            return false;
+                    }
+                    sf::vprint(stream, std::string_view(formats[id]), std::move(args));
+                    if (kind == 'L')
+                        stream << std::endl;
+                }
+                else
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+} // namespace sf
+
+#endif // !SF_DEFERRED_HPP
@@ -0,0 +1,271 @@
+/**StreamFormat fast_input.hpp
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2018-2020 Berrysoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+#ifndef SF_FAST_INPUT_HPP
+#define SF_FAST_INPUT_HPP
+
+#include <sf/utility.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <istream>
+#include <locale>
+#include <sf/format.hpp>
+#include <sf/unicode.hpp>
+#include <system_error>
+#include <vector>
+
+#ifdef _WIN32
+    #include <io.h>
+#else
+    #include <unistd.h>
+#endif // _WIN32
+
+namespace sf
+{
+    namespace internal
+    {
+        //Read up to count bytes, retrying when interrupted. Returns 0 at the end, or -1 on
+        //another error, such as EAGAIN or EIO, with errno set.
+        inline std::ptrdiff_t read_fd(int fd, char* buffer, std::size_t count) noexcept
+        {
+            while (true)
+            {
+#ifdef _WIN32
+                int n = ::_read(fd, buffer, static_cast<unsigned int>(count < 0x40000000 ? count : 0x40000000));
+#else
+                ssize_t n = ::read(fd, buffer, count);
+#endif // _WIN32
+                if (n >= 0 || errno != EINTR)
+                    return static_cast<std::ptrdiff_t>(n);
+            }
+        }
+
+        //Length of an incomplete UTF-8 sequence at the end of the bytes.
+        inline std::size_t utf8_incomplete_tail(const char* first, const char* last) noexcept
+        {
+            for (std::size_t n = 1; n <= 3 && last - first >= static_cast<std::ptrdiff_t>(n); n++)
+            {
+                unsigned char c = static_cast<unsigned char>(last[-static_cast<std::ptrdiff_t>(n)]);
+                if ((c & 0xC0) == 0x80)
+                    continue;
+                std::size_t length = c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : c >= 0xC0 ? 2 : 1;
+                return length > n ? n : 0;
+            }
+            return 0;
+        }
+    } // namespace internal
+
+    //A stream buffer which reads blocks from a file descriptor with read(2).
+    //A wide buffer decodes UTF-8 bytes.
+    template <typename Char, typename Traits = std::char_traits<Char>>
+    class basic_fd_streambuf : public internal::block_streambuf<Char, Traits>
+    {
+    public:
+        using int_type = typename Traits::int_type;
+
+    private:
+        int fd;
+        std::vector<Char> buffer;
+        //Bytes read and not decoded yet, for a wide buffer.
+        std::vector<char> bytes;
+        std::size_t pending = 0;
+        bool end = false;
+        int last_error = 0;
+        std::basic_ios<Char, Traits>* owner = nullptr;
+
+        //Read into [first, first + count) and return the count of characters, or -1 on an error.
+        std::ptrdiff_t read(Char* first, std::size_t count)
+        {
+            if constexpr (sizeof(Char) == 1)
+            {
+                return internal::read_fd(fd, reinterpret_cast<char*>(first), count);
+            }
+            else
+            {
+                //Every byte yields at most one code unit, so the pending bytes take room as well.
+                const std::size_t room = count > pending ? count - pending : 0;
+                if (bytes.size() < pending + room)
+                    bytes.resize(pending + room);
+                const std::ptrdiff_t read = internal::read_fd(fd, bytes.data() + pending, room);
+                if (read < 0)
+                    return -1;
+                const std::size_t n = static_cast<std::size_t>(read);
+                const char* it = bytes.data();
+                const char* last = it + pending + n;
+                //The tail of a sequence split by the block waits for the next read.
+                const char* stop = n ? last - internal::utf8_incomplete_tail(it, last) : last;
+                Char* dest = first;
+                while (it != stop)
+                {
+                    std::size_t len = internal::ascii_prefix(it, static_cast<std::size_t>(stop - it));
+                    dest = internal::widen_ascii(it, len, dest);
+                    it += len;
+                    if (it != stop)
+                        dest = internal::utf_encode(internal::utf8_decode(it, stop), dest);
+                }
+                pending = static_cast<std::size_t>(last - stop);
+                std::memmove(bytes.data(), stop, pending);
+                return dest - first;
+            }
+        }
+
+    public:
+        explicit basic_fd_streambuf(int fd, std::size_t capacity = 65536) : fd(fd), buffer(capacity < 16 ? 16 : capacity)
+        {
+            this->setg(buffer.data(), buffer.data(), buffer.data());
+        }
+
+        int descriptor() const noexcept { return fd; }
+        //The errno of the last failed read, or 0.
+        int error() const noexcept { return last_error; }
+        //Set badbit on the stream when a read fails, also for the callers of refill outside istream.
+        void attach(std::basic_ios<Char, Traits>* stream) noexcept { owner = stream; }
+
+        bool refill() override
+        {
+            if (end)
+                return false;
+            const std::size_t kept = static_cast<std::size_t>(this->egptr() - this->gptr());
+            if (kept && this->gptr() != buffer.data())
+                Traits::move(buffer.data(), this->gptr(), kept);
+            //A token longer than the buffer grows it.
+            if (kept * 2 > buffer.size())
+                buffer.resize(buffer.size() * 2);
+            std::ptrdiff_t n = 0;
+            last_error = 0;
+            //A block of only a split sequence decodes to nothing, so read again.
+            while (n == 0 && !end)
+            {
+                n = read(buffer.data() + kept, buffer.size() - kept);
+                if (n == 0 && (sizeof(Char) == 1 || pending == 0))
+                    end = true;
+            }
+            //An error isn't the end, so a later call reads again, as after EAGAIN.
+            if (n < 0)
+            {
+                last_error = errno;
+                n = 0;
+            }
+            this->setg(buffer.data(), buffer.data(), buffer.data() + kept + n);
+            if (last_error && owner)
+                owner->setstate(std::ios_base::badbit);
+            return n > 0;
+        }
+
+    protected:
+        int_type underflow() override
+        {
+            if (this->gptr() == this->egptr() && !refill())
+            {
+                //istream catches it and sets badbit, without eofbit.
+                if (last_error)
+                    throw std::ios_base::failure("read failed", std::error_code(last_error, std::generic_category()));
+                return Traits::eof();
+            }
+            return Traits::to_int_type(*this->gptr());
+        }
+
+        std::streamsize showmanyc() override
+        {
+            return end ? -1 : 0;
+        }
+    };
+
+    using fd_streambuf = basic_fd_streambuf<char>;
+    using wfd_streambuf = basic_fd_streambuf<wchar_t>;
+
+    namespace internal
+    {
+        //Holds the buffer, so that it is constructed before the stream base.
+        template <typename Char, typename Traits>
+        struct fd_streambuf_holder
+        {
+            basic_fd_streambuf<Char, Traits> buf;
+
+            fd_streambuf_holder(int fd, std::size_t capacity) : buf(fd, capacity) {}
+        };
+    } // namespace internal
+
+    //An input stream over a file descriptor. In the classic locale, scan parses integers and
+    //floating-point numbers in the buffer with from_chars, with the same results as operator>>.
+    template <typename Char, typename Traits = std::char_traits<Char>>
+    class basic_fast_input : private internal::fd_streambuf_holder<Char, Traits>, public std::basic_istream<Char, Traits>
+    {
+    private:
+        using holder_type = internal::fd_streambuf_holder<Char, Traits>;
+        using block_type = internal::block_streambuf<Char, Traits>;
+
+        //In-place parsing follows the locale, which may be changed by imbue.
+        void update()
+        {
+            block_type* buf = &this->holder_type::buf;
+            this->pword(block_type::index) = this->getloc() == std::locale::classic() ? buf : nullptr;
+        }
+
+        static void on_event(std::ios_base::event e, std::ios_base& stream, int)
+        {
+            if (e == std::ios_base::imbue_event)
+            {
+                if (auto self = dynamic_cast<basic_fast_input*>(&stream))
+                    self->update();
+            }
+        }
+
+    public:
+        explicit basic_fast_input(int fd, std::size_t capacity = 65536) : holder_type(fd, capacity), std::basic_istream<Char, Traits>(&this->holder_type::buf)
+        {
+            update();
+            this->register_callback(&on_event, 0);
+            this->holder_type::buf.attach(this);
+        }
+
+        basic_fd_streambuf<Char, Traits>* rdbuf() const noexcept { return const_cast<basic_fd_streambuf<Char, Traits>*>(&this->holder_type::buf); }
+    };
+
+    using fast_input = basic_fast_input<char>;
+    using wfast_input = basic_fast_input<wchar_t>;
+
+    //The standard input, read in blocks. Don't mix it with std::cin or stdio on the same thread of input.
+    //It is tied to std::cout as std::cin is, so a prompt is flushed before reading.
+    inline fast_input& fast_stdin()
+    {
+        static fast_input stream(0);
+        static std::ostream* const previous = stream.tie(&std::cout);
+        static_cast<void>(previous);
+        return stream;
+    }
+    //The standard input decoded from UTF-8, tied to std::wcout.
+    inline wfast_input& wfast_stdin()
+    {
+        static wfast_input stream(0);
+        static std::wostream* const previous = stream.tie(&std::wcout);
+        static_cast<void>(previous);
+        return stream;
+    }
+} // namespace sf
+
+#endif // !SF_FAST_INPUT_HPP
@@ -0,0 +1,277 @@
+/**StreamFormat fixed_string.hpp
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2018-2020 Berrysoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+#ifndef SF_FIXED_STRING_HPP
+#define SF_FIXED_STRING_HPP
+
+#include <sf/utility.hpp>
+
+#include <cstddef>
+#include <ostream>
+#include <sf/format.hpp>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+namespace sf
+{
+    //A string with inline storage of N characters, usable in constant expressions.
+    template <typename Char, std::size_t N, typename Traits = std::char_traits<Char>>
+    class fixed_string
+    {
+    public:
+        using value_type = Char;
+        using size_type = std::size_t;
+        using string_view_type = std::basic_string_view<Char, Traits>;
+        using const_iterator = const Char*;
+
+    private:
+        Char buffer[N + 1];
+        size_type len;
+
+    public:
+        constexpr fixed_string() noexcept : buffer{}, len(0) {}
+        constexpr fixed_string(string_view_type str) : buffer{}, len(0) { append(str.data(), str.length()); }
+
+        constexpr const Char* data() const noexcept { return buffer; }
+        constexpr const Char* c_str() const noexcept { return buffer; }
+        constexpr size_type size() const noexcept { return len; }
+        constexpr size_type length() const noexcept { return len; }
+        static constexpr size_type capacity() noexcept { return N; }
+        constexpr bool empty() const noexcept { return len == 0; }
+
+        constexpr const_iterator begin() const noexcept { return buffer; }
+        constexpr const_iterator end() const noexcept { return buffer + len; }
+        constexpr const Char& operator[](size_type pos) const noexcept { return buffer[pos]; }
+
+        constexpr string_view_type view() const noexcept { return string_view_type(buffer, len); }
+        constexpr operator string_view_type() const noexcept { return view(); }
+
+        constexpr void push_back(Char c)
+        {
+            if (len == N)
+                throw std::length_error("fixed_string is full");
+            buffer[len++] = c;
+        }
+        constexpr fixed_string& append(size_type count, Char c)
+        {
+            if (count > N - len)
+                throw std::length_error("fixed_string is full");
+            for (size_type i = 0; i < count; i++)
+                buffer[len++] = c;
+            return *this;
+        }
+        constexpr fixed_string& append(const Char* str, size_type count)
+        {
+            if (count > N - len)
+                throw std::length_error("fixed_string is full");
+            for (size_type i = 0; i < count; i++)
+                buffer[len++] = str[i];
+            return *this;
+        }
+        constexpr void clear() noexcept
+        {
+            len = 0;
+            buffer[0] = Char{};
+        }
+
+        friend constexpr bool operator==(const fixed_string& lhs, string_view_type rhs) noexcept { return lhs.view() == rhs; }
+        friend constexpr bool operator==(string_view_type lhs, const fixed_string& rhs) noexcept { return lhs == rhs.view(); }
+        friend constexpr bool operator!=(const fixed_string& lhs, string_view_type rhs) noexcept { return lhs.view() != rhs; }
+        friend constexpr bool operator!=(string_view_type lhs, const fixed_string& rhs) noexcept { return lhs != rhs.view(); }
+
+        friend std::basic_ostream<Char, Traits>& operator<<(std::basic_ostream<Char, Traits>& stream, const fixed_string& str)
+        {
+            return stream << str.view();
+        }
+    };
+
+    namespace internal
+    {
+        template <typename T, typename Char>
+        struct is_fixed_string : std::false_type
+        {
+        };
+        template <typename Char, std::size_t N, typename Traits>
+        struct is_fixed_string<fixed_string<Char, N, Traits>, Char> : std::true_type
+        {
+        };
+
+        template <typename T, typename Char>
+        inline constexpr bool is_fixed_sprint_string_v = std::is_same_v<T, const Char*> || std::is_same_v<T, Char*> || std::is_same_v<T, std::basic_string_view<Char>> || is_fixed_string<T, Char>::value;
+
+        //The stream state which the flags of a placeholder set.
+        template <typename Char>
+        struct fixed_spec
+        {
+            std::ios_base::fmtflags flags;
+            Char fill;
+            std::size_t width;
+        };
+
+        //The flags are split as format_arg_io splits them.
+        template <typename Char>
+        constexpr fixed_spec<Char> parse_fixed_spec(std::basic_string_view<Char> fmts) noexcept
+        {
+            fixed_spec<Char> spec{ std::ios_base::dec, Char{ ' ' }, 0 };
+            format_flags_walk(fmts, [&](Char flag, int n) {
+                const auto set = [&](std::ios_base::fmtflags value, std::ios_base::fmtflags mask, Char fill) {
+                    spec.flags = (spec.flags & ~mask) | value;
+                    spec.fill = fill;
+                    spec.width = static_cast<std::size_t>(n);
+                };
+                switch (flag)
+                {
+                case Char{ 'd' }:
+                    set(std::ios_base::dec, std::ios_base::basefield, Char{ '0' });
+                    break;
+                case Char{ 'o' }:
+                    set(std::ios_base::oct, std::ios_base::basefield, Char{ '0' });
+                    break;
+                case Char{ 'x' }:
+                    set(std::ios_base::hex, std::ios_base::basefield, Char{ '0' });
+                    break;
+                case Char{ 'l' }:
+                    set(std::ios_base::left, std::ios_base::adjustfield, Char{ ' ' });
+                    break;
+                case Char{ 'r' }:
+                    set(std::ios_base::right, std::ios_base::adjustfield, Char{ ' ' });
+                    break;
+                case Char{ 'i' }:
+                    set(std::ios_base::internal, std::ios_base::adjustfield, Char{ ' ' });
+                    break;
+                case Char{ 'b' }:
+                    spec.flags = spec.flags | std::ios_base::boolalpha;
+                    break;
+                case Char{ 'u' }:
+                    spec.flags = spec.flags | std::ios_base::uppercase;
+                    break;
+                case Char{ 's' }:
+                    spec.flags = spec.flags | std::ios_base::showbase;
+                    break;
+                default:
+                    break;
+                }
+            });
+            return spec;
+        }
+
+        //Pad as put_padded does, with prefix characters before the fill if internal.
+        template <typename Char, std::size_t N, typename Traits>
+        constexpr void fixed_put(fixed_string<Char, N, Traits>& out, const Char* str, std::size_t len, std::size_t prefix, const fixed_spec<Char>& spec)
+        {
+            const std::size_t pad = spec.width > len ? spec.width - len : 0;
+            const std::ios_base::fmtflags adjust = spec.flags & std::ios_base::adjustfield;
+            if (adjust == std::ios_base::left)
+            {
+                out.append(str, len);
+                out.append(pad, spec.fill);
+            }
+            else if (adjust == std::ios_base::internal)
+            {
+                out.append(str, prefix);
+                out.append(pad, spec.fill);
+                out.append(str + prefix, len - prefix);
+            }
+            else
+            {
+                out.append(pad, spec.fill);
+                out.append(str, len);
+            }
+        }
+
+        template <typename Char, std::size_t N, typename Traits, typename T>
+        constexpr void fixed_put_arg(fixed_string<Char, N, Traits>& out, const T& arg, const fixed_spec<Char>& spec)
+        {
+            if constexpr (std::is_same_v<T, bool>)
+            {
+                if (spec.flags & std::ios_base::boolalpha)
+                {
+                    constexpr Char t[] = { Char{ 't' }, Char{ 'r' }, Char{ 'u' }, Char{ 'e' } };
+                    constexpr Char f[] = { Char{ 'f' }, Char{ 'a' }, Char{ 'l' }, Char{ 's' }, Char{ 'e' } };
+                    fixed_put(out, arg ? t : f, arg ? 4 : 5, 0, spec);
+                }
+                else
+                {
+                    //As a long, as num_put writes it, so the base and showbase apply.
+                    fixed_put_arg(out, static_cast<long>(arg), spec);
+                }
+            }
+            else if constexpr (is_fast_char_v<T, Char>)
+            {
+                const Char c = static_cast<Char>(arg);
+                fixed_put(out, &c, 1, 0, spec);
+            }
+            else if constexpr (is_fast_integer_v<T>)
+            {
+                Char buffer[integer_buffer_size]{};
+                std::size_t prefix = 0;
+                Char* last = buffer + integer_buffer_size;
+                Char* first = format_integer(last, arg, spec.flags, prefix);
+                fixed_put(out, first, static_cast<std::size_t>(last - first), prefix, spec);
+            }
+            else if constexpr (is_fixed_sprint_string_v<std::decay_t<T>, Char>)
+            {
+                std::basic_string_view<Char> str(arg);
+                fixed_put(out, str.data(), str.length(), 0, spec);
+            }
+            else
+            {
+                static_assert(is_fixed_sprint_string_v<std::decay_t<T>, Char>, "fixed_sprint supports integers, bools, characters and strings only.");
+            }
+        }
+
+        template <std::size_t N, typename Char, typename Traits, typename... Args>
+        constexpr fixed_string<Char, N, Traits> fixed_format(std::basic_string_view<Char> fmt, const Args&... args)
+        {
+            fixed_string<Char, N, Traits> out;
+            //The same walk as print, so fields and escapes are read alike.
+            format_walk(
+                fmt, sizeof...(Args), static_cast<const std::basic_string_view<Char>*>(nullptr),
+                [&](std::basic_string_view<Char> text) { out.append(text.data(), text.length()); },
+                [&](std::size_t arg_index, std::basic_string_view<Char> spec, bool) {
+                    const fixed_spec<Char> s = parse_fixed_spec(spec);
+                    std::size_t current = 0;
+                    ((current++ == arg_index ? fixed_put_arg(out, args, s) : void()), ...);
+                });
+            return out;
+        }
+    } // namespace internal
+
+    //Format integers, bools, characters and strings into a fixed_string, also in constant expressions.
+    //The flags are the same as print, except those for floating-point numbers.
+    template <std::size_t N, typename Char, typename... Args>
+    constexpr fixed_string<Char, N> fixed_sprint(const Char* fmt, const Args&... args)
+    {
+        return internal::fixed_format<N, Char, std::char_traits<Char>>(std::basic_string_view<Char>(fmt), args...);
+    }
+    template <std::size_t N, typename Char, typename... Args>
+    constexpr fixed_string<Char, N> fixed_sprint(std::basic_string_view<Char> fmt, const Args&... args)
+    {
+        return internal::fixed_format<N, Char, std::char_traits<Char>>(fmt, args...);
+    }
+} // namespace sf
+
+#endif // !SF_FIXED_STRING_HPP
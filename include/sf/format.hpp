@@ -28,6 +28,11 @@
 
 #include <sf/utility.hpp>
 
+#include <sf/charconv.hpp>
+#include <sf/formatter.hpp>
+#include <sf/hexdump.hpp>
+#include <sf/unicode.hpp>
+#include <atomic>
 #include <functional>
 #include <iomanip>
 #include <iostream>
@@ -36,6 +41,15 @@
 #include <tuple>
 #include <vector>
 
+#ifdef SF_ENABLE_STATS
+    #include <chrono>
+    #include <cstdint>
+    #include <deque>
+    #include <memory>
+    #include <mutex>
+    #include <unordered_map>
+#endif // SF_ENABLE_STATS
+
 namespace sf
 {
     namespace internal
@@ -64,6 +78,59 @@ namespace sf
         template <io_state IOState, typename Char, typename Traits>
         using stream_t = typename stream<IOState, Char, Traits>::type;
 
+        //Format state beyond std::ios_base::fmtflags, stored in an iword of the stream.
+        struct format_ext
+        {
+            inline static const int index = std::ios_base::xalloc();
+
+            enum : long
+            {
+                locale_free = 0x1,
+                hexdump = 0x2,
+                hex_ascii = 0x4,
+                hex_offset = 0x8,
+                display_width = 0x10
+            };
+
+            //Small numbers stored in the higher bits, plus one so that 0 means unset.
+            enum : int
+            {
+                hex_line_shift = 8,
+                hex_group_shift = 16
+            };
+
+            //Set for the whole program when a translation unit defines SF_USE_LOCALE_FREE. It is
+            //read at run time, so test is the same in every translation unit and the compiled library.
+            inline static std::atomic<bool> always_locale_free{ false };
+
+            static bool test(std::ios_base& stream, long flag)
+            {
+                if (flag == locale_free && always_locale_free.load(std::memory_order_relaxed))
+                    return true;
+                return stream.iword(index) & flag;
+            }
+
+            static void set_field(std::ios_base& stream, int shift, int value)
+            {
+                long& ext = stream.iword(index);
+                ext = (ext & ~(0xffL << shift)) | (static_cast<long>(value < 0 ? 0 : value > 254 ? 254 : value) + 1) << shift;
+            }
+            //Returns -1 if unset.
+            static int get_field(std::ios_base& stream, int shift)
+            {
+                return static_cast<int>((stream.iword(index) >> shift) & 0xff) - 1;
+            }
+        };
+
+#ifdef SF_USE_LOCALE_FREE
+        namespace
+        {
+            //Turns on the locale-free path at static initialization. Local to each translation unit,
+            //so units with and without the macro define nothing differently.
+            [[maybe_unused]] const bool use_locale_free = (format_ext::always_locale_free.store(true, std::memory_order_relaxed), true);
+        } // namespace
+#endif // SF_USE_LOCALE_FREE
+
         template <typename Stream>
         struct arg
         {
@@ -76,6 +143,345 @@ namespace sf
         template <typename Stream>
         using arg_list_t = typename arg<Stream>::list_type;
 
+        template <typename Char, typename Traits, typename Range>
+        std::basic_ostream<Char, Traits>& put_bytes(std::basic_ostream<Char, Traits>& stream, const Range& range)
+        {
+            hexdump_options options{ 0, 1, format_ext::test(stream, format_ext::hex_ascii), format_ext::test(stream, format_ext::hex_offset), static_cast<bool>(stream.flags() & std::ios_base::uppercase) };
+            if (format_ext::test(stream, format_ext::hexdump))
+            {
+                int line = format_ext::get_field(stream, format_ext::hex_line_shift);
+                options.line = line > 0 ? static_cast<std::size_t>(line) : 16;
+            }
+            int group = format_ext::get_field(stream, format_ext::hex_group_shift);
+            if (group >= 0)
+                options.group = static_cast<std::size_t>(group);
+            return put_hexdump(stream, reinterpret_cast<const unsigned char*>(std::data(range)), std::size(range), options);
+        }
+
+        //Make the padding of UTF-8 text count terminal columns instead of code units.
+        template <typename Traits>
+        void adjust_display_width(std::basic_ostream<char, Traits>& stream, std::string_view str)
+        {
+            const std::size_t ascii = ascii_prefix(str.data(), str.length());
+            if (ascii == str.length())
+                return;
+            const std::size_t columns = ascii + display_width(str.data() + ascii, str.length() - ascii);
+            stream.width(stream.width() + static_cast<std::streamsize>(str.length()) - static_cast<std::streamsize>(columns));
+        }
+
+        template <typename Char>
+        constexpr bool is_digit(Char c) noexcept
+        {
+            return c >= Char{ '0' } && c <= Char{ '9' };
+        }
+
+        //A stream buffer whose get area holds whole blocks of input, so that numbers are parsed
+        //in place. See <sf/fast_input.hpp>.
+        template <typename Char, typename Traits>
+        class block_streambuf : public std::basic_streambuf<Char, Traits>
+        {
+        public:
+            //The stream, in the classic locale, stores its block_streambuf in this pword.
+            inline static const int index = std::ios_base::xalloc();
+
+            std::basic_string_view<Char, Traits> available() const noexcept
+            {
+                return std::basic_string_view<Char, Traits>(this->gptr(), static_cast<std::size_t>(this->egptr() - this->gptr()));
+            }
+
+            void consume(std::size_t count) { this->gbump(static_cast<int>(count)); }
+
+            //Read more input after the characters not consumed. Returns false at the end of input.
+            virtual bool refill() = 0;
+
+            static block_streambuf* of(std::basic_istream<Char, Traits>& stream)
+            {
+                void* ptr = stream.pword(index);
+                return ptr && ptr == static_cast<void*>(stream.rdbuf()) ? static_cast<block_streambuf*>(ptr) : nullptr;
+            }
+        };
+
+        template <typename T>
+        inline constexpr bool is_in_place_v = is_fast_integer_v<T> || std::is_floating_point_v<T>;
+
+        template <typename Char>
+        constexpr bool is_number_char(Char c) noexcept
+        {
+            return is_digit(c) || (c >= Char{ 'a' } && c <= Char{ 'z' }) || (c >= Char{ 'A' } && c <= Char{ 'Z' }) || c == Char{ '.' } || c == Char{ '+' } || c == Char{ '-' };
+        }
+
+        //The base of integers which num_get reads, or 0 if it detects the base by the prefix.
+        inline int number_base(std::ios_base::fmtflags flags) noexcept
+        {
+            switch (flags & std::ios_base::basefield)
+            {
+            case std::ios_base::dec:
+                return 10;
+            case std::ios_base::hex:
+                return 16;
+            case std::ios_base::oct:
+                return 8;
+            default:
+                return 0;
+            }
+        }
+
+        //Parse a number as num_get does. [first, last) holds a whole token, and may go on
+        //after it for the vector kernel. Returns nullptr for the input that from_chars treats
+        //differently, which is left to operator>>.
+        template <typename Char, typename T>
+        const Char* parse_in_place(const Char* first, const Char* last, T& value, int base) noexcept
+        {
+            const Char* digits = first != last && (*first == Char{ '+' } || *first == Char{ '-' }) ? first + 1 : first;
+            //from_chars reads "inf" and "nan", but num_get does not.
+            if (digits == last || (std::is_floating_point_v<T> && !is_digit(*digits) && *digits != Char{ '.' }))
+                return nullptr;
+            T result;
+            const Char* end = parse_number(first, last, result, base);
+            if (!end)
+                return nullptr;
+            if constexpr (std::is_floating_point_v<T>)
+            {
+                //num_get fails on a dangling exponent.
+                if (end != last && (*end == Char{ 'e' } || *end == Char{ 'E' }))
+                    return nullptr;
+            }
+            value = result;
+            return end;
+        }
+
+        //Parse a number in the buffer. Returns false if it is left to operator>>.
+        template <typename Char, typename Traits, typename T>
+        bool get_in_place(std::basic_istream<Char, Traits>& stream, block_streambuf<Char, Traits>& buf, T& value)
+        {
+            const int base = number_base(stream.flags());
+            if (!base)
+                return false;
+            typename std::basic_istream<Char, Traits>::sentry ok(stream);
+            if (!ok)
+                return true;
+            std::basic_string_view<Char, Traits> text = buf.available();
+            std::size_t length = 0;
+            bool more = true;
+            while (true)
+            {
+                while (length < text.length() && is_number_char(text[length]))
+                    length++;
+                if (length < text.length() || !more)
+                    break;
+                more = buf.refill();
+                text = buf.available();
+            }
+            const Char* end = parse_in_place(text.data(), text.data() + text.length(), value, base);
+            if (!end)
+                return false;
+            buf.consume(static_cast<std::size_t>(end - text.data()));
+            if (end == text.data() + text.length() && !more)
+                stream.setstate(std::ios_base::eofbit);
+            return true;
+        }
+
+        template <typename T>
+        struct is_basic_string : std::false_type
+        {
+        };
+        template <typename Char, typename Traits, typename Allocator>
+        struct is_basic_string<std::basic_string<Char, Traits, Allocator>> : std::true_type
+        {
+        };
+
+        //Containers with push_back, except strings, and inserters such as std::back_inserter,
+        //which are scanned as lists.
+        template <typename T, typename = void>
+        struct list_element
+        {
+            using type = void;
+        };
+        template <typename T>
+        struct list_element<T, std::void_t<typename T::container_type, decltype(*std::declval<T&>()++ = std::declval<const typename T::container_type::value_type&>())>>
+        {
+            using type = typename T::container_type::value_type;
+        };
+        template <typename T>
+        struct list_element<T, std::enable_if_t<!is_char_type_v<typename T::value_type>, std::void_t<decltype(std::declval<T&>().push_back(std::declval<typename T::value_type>()))>>>
+        {
+            using type = typename T::value_type;
+        };
+
+        template <typename T>
+        using list_element_t = typename list_element<T>::type;
+        template <typename T>
+        inline constexpr bool is_list_v = !std::is_void_v<list_element_t<T>>;
+
+        template <typename T, typename Char, typename Traits, typename = void>
+        struct has_extractor : std::false_type
+        {
+        };
+        template <typename T, typename Char, typename Traits>
+        struct has_extractor<T, Char, Traits, std::void_t<decltype(std::declval<std::basic_istream<Char, Traits>&>() >> std::declval<T&>())>> : std::true_type
+        {
+        };
+
+        //A list type with its own operator>> is scanned as a list only with a "[...]" group in the spec.
+        template <typename Char, typename Traits>
+        bool has_list_spec(std::basic_string_view<Char> spec) noexcept
+        {
+            return spec.find(Char{ '[' }) != std::basic_string_view<Char>::npos;
+        }
+
+        template <typename Char, typename Traits>
+        constexpr bool is_blank(typename Traits::int_type c) noexcept
+        {
+            return Traits::eq_int_type(c, Traits::to_int_type(Char{ ' ' })) || Traits::eq_int_type(c, Traits::to_int_type(Char{ '\t' })) || Traits::eq_int_type(c, Traits::to_int_type(Char{ '\r' }));
+        }
+
+        //Skip spaces and tabs, but not a new line. Returns the next character.
+        template <typename Char, typename Traits>
+        typename Traits::int_type skip_blanks(std::basic_istream<Char, Traits>& stream)
+        {
+            std::basic_streambuf<Char, Traits>& buf = *stream.rdbuf();
+            typename Traits::int_type c = buf.sgetc();
+            while (is_blank<Char, Traits>(c))
+                c = buf.snextc();
+            if (Traits::eq_int_type(c, Traits::eof()))
+                stream.setstate(std::ios_base::eofbit);
+            return c;
+        }
+
+        //Scan one element of a list. A string ends at a space or the separator.
+        template <typename Char, typename Traits, typename T>
+        void get_element(std::basic_istream<Char, Traits>& stream, T& value, typename Traits::int_type sep)
+        {
+            if constexpr (is_in_place_v<T>)
+            {
+                if (auto buf = block_streambuf<Char, Traits>::of(stream))
+                {
+                    if (get_in_place(stream, *buf, value))
+                        return;
+                }
+                stream >> value;
+            }
+            else if constexpr (is_basic_string<T>::value)
+            {
+                std::basic_streambuf<Char, Traits>& buf = *stream.rdbuf();
+                value.clear();
+                typename Traits::int_type c = buf.sgetc();
+                while (!Traits::eq_int_type(c, Traits::eof()) && !Traits::eq_int_type(c, sep) && !is_space(Traits::to_char_type(c)))
+                {
+                    value.push_back(Traits::to_char_type(c));
+                    c = buf.snextc();
+                }
+                if (Traits::eq_int_type(c, Traits::eof()))
+                    stream.setstate(std::ios_base::eofbit);
+                if (value.empty())
+                    stream.setstate(std::ios_base::failbit);
+            }
+            else
+            {
+                stream >> value;
+            }
+        }
+
+        template <typename List, typename T>
+        void push_list(List& list, T&& value)
+        {
+            if constexpr (std::is_void_v<typename List::value_type>)
+                *list++ = std::forward<T>(value);
+            else
+                list.push_back(std::forward<T>(value));
+        }
+
+        //Scan the elements which lie in the buffer with their separators, without the stream.
+        //It stops before an element which needs more input or operator>>, or which may be the last.
+        template <typename Char, typename Traits, typename List>
+        void get_list_in_place(block_streambuf<Char, Traits>& buf, List& list, typename Traits::int_type sep, int base)
+        {
+            using element_type = list_element_t<List>;
+            const bool has_sep = !Traits::eq_int_type(sep, Traits::eof());
+            const std::basic_string_view<Char, Traits> text = buf.available();
+            const Char* const begin = text.data();
+            const Char* const last = begin + text.length();
+            const Char* it = begin;
+            while (true)
+            {
+                element_type value;
+                const Char* next = parse_in_place(it, last, value, base);
+                //A number which reaches the end of the buffer may go on in the next block.
+                if (!next || next == last)
+                    break;
+                while (next != last && is_blank<Char, Traits>(Traits::to_int_type(*next)))
+                    next++;
+                if (has_sep)
+                {
+                    if (next == last || !Traits::eq_int_type(Traits::to_int_type(*next), sep))
+                        break;
+                    next++;
+                    while (next != last && is_blank<Char, Traits>(Traits::to_int_type(*next)))
+                        next++;
+                }
+                if (next == last || Traits::eq(*next, Char{ '\n' }))
+                    break;
+                push_list(list, value);
+                it = next;
+            }
+            buf.consume(static_cast<std::size_t>(it - begin));
+        }
+
+        //Scan elements to the end of the line, separated by spaces, or by the separator
+        //given as "[sep=,]". The new line is not consumed.
+        template <typename Char, typename Traits, typename List>
+        std::basic_istream<Char, Traits>& get_list(std::basic_istream<Char, Traits>& stream, List& list)
+        {
+            using element_type = list_element_t<List>;
+            constexpr Char prefix[] = { Char{ '[' }, Char{ 's' }, Char{ 'e' }, Char{ 'p' }, Char{ '=' } };
+            const std::basic_string_view<Char> spec = format_spec::get<Char, Traits>(stream);
+            const std::size_t pos = spec.find(std::basic_string_view<Char>(prefix, 5));
+            const bool has_sep = pos != std::basic_string_view<Char>::npos && pos + 5 < spec.length();
+            const typename Traits::int_type sep = has_sep ? Traits::to_int_type(spec[pos + 5]) : Traits::eof();
+            const typename Traits::int_type new_line = Traits::to_int_type(Char{ '\n' });
+            if (!stream.good())
+            {
+                stream.setstate(std::ios_base::failbit);
+                return stream;
+            }
+            typename Traits::int_type c = skip_blanks(stream);
+            while (!Traits::eq_int_type(c, Traits::eof()) && !Traits::eq_int_type(c, new_line))
+            {
+                if constexpr (is_in_place_v<element_type>)
+                {
+                    const int base = number_base(stream.flags());
+                    auto buf = block_streambuf<Char, Traits>::of(stream);
+                    if (buf && base)
+                    {
+                        get_list_in_place(*buf, list, sep, base);
+                        c = skip_blanks(stream);
+                        if (Traits::eq_int_type(c, Traits::eof()) || Traits::eq_int_type(c, new_line))
+                            break;
+                    }
+                }
+                element_type value{};
+                get_element(stream, value, sep);
+                if (stream.fail())
+                    break;
+                push_list(list, std::move(value));
+                if (stream.eof())
+                    break;
+                c = skip_blanks(stream);
+                if (has_sep)
+                {
+                    //Without a separator after it, the element is the last.
+                    if (!Traits::eq_int_type(c, sep))
+                        break;
+                    stream.rdbuf()->sbumpc();
+                    c = skip_blanks(stream);
+                    //A separator must be followed by an element.
+                    if (Traits::eq_int_type(c, Traits::eof()) || Traits::eq_int_type(c, new_line))
+                        stream.setstate(std::ios_base::failbit);
+                }
+            }
+            return stream;
+        }
+
         //A packed arg.
         template <io_state IOState, typename T, typename Char, typename Traits>
         class arg_io
@@ -90,13 +496,128 @@ namespace sf
             arg_io(T&& arg) noexcept(std::is_nothrow_move_constructible_v<T>) : arg(std::forward<T>(arg)) {}
             constexpr stream_type& operator()(stream_type& stream)
             {
+                using value_type = std::remove_cv_t<std::remove_reference_t<T>>;
                 if constexpr (IOState == input)
-                    return stream >> arg;
+                {
+                    if constexpr (has_scanner_v<value_type, Char>)
+                    {
+                        return get_scanned(stream, arg);
+                    }
+                    else if constexpr (is_list_v<value_type> && !has_extractor<value_type, Char, Traits>::value)
+                    {
+                        return get_list(stream, arg);
+                    }
+                    else
+                    {
+                        if constexpr (is_list_v<value_type>)
+                        {
+                            if (has_list_spec<Char, Traits>(format_spec::get<Char, Traits>(stream)))
+                                return get_list(stream, arg);
+                        }
+                        if constexpr (is_in_place_v<value_type>)
+                        {
+                            if (auto buf = block_streambuf<Char, Traits>::of(stream))
+                            {
+                                if (get_in_place(stream, *buf, arg))
+                                    return stream;
+                            }
+                        }
+                        return stream >> arg;
+                    }
+                }
+                else if constexpr (has_formatter_v<value_type, Char>)
+                {
+                    return put_formatted(stream, arg);
+                }
                 else
-                    return stream << arg;
+                {
+                    if constexpr (std::is_same_v<Char, char> && std::is_convertible_v<const value_type&, std::string_view>)
+                    {
+                        if (stream.width() > 0 && format_ext::test(stream, format_ext::display_width))
+                            adjust_display_width(stream, std::string_view(arg));
+                    }
+                    if constexpr (is_locale_free_v<value_type, Char>)
+                    {
+                        if (format_ext::test(stream, format_ext::locale_free))
+                            return put_locale_free(stream, arg);
+                    }
+                    if constexpr (is_byte_range_v<value_type>)
+                    {
+                        //Containers without operator<< are always dumped.
+                        if constexpr (is_streamable<value_type, Char, Traits>::value)
+                        {
+                            if (!format_ext::test(stream, format_ext::hexdump))
+                                return stream << arg;
+                        }
+                        return put_bytes(stream, arg);
+                    }
+                    else
+                    {
+                        return stream << arg;
+                    }
+                }
             }
         };
 
+        //An argument referred by name.
+        template <typename Char, typename T>
+        struct named_arg
+        {
+            std::basic_string_view<Char> name;
+            T value;
+        };
+
+        template <typename T>
+        struct is_named_arg : std::false_type
+        {
+        };
+        template <typename Char, typename T>
+        struct is_named_arg<named_arg<Char, T>> : std::true_type
+        {
+        };
+
+        template <typename... Args>
+        inline constexpr bool has_named_arg_v = (is_named_arg<std::remove_cv_t<std::remove_reference_t<Args>>>::value || ...);
+
+        template <typename T, typename U>
+        struct unwrap_named
+        {
+            using type = T;
+        };
+        template <typename T, typename Char, typename V>
+        struct unwrap_named<T, named_arg<Char, V>>
+        {
+            using type = V;
+        };
+
+        template <typename T>
+        using unwrap_named_t = typename unwrap_named<T, std::remove_cv_t<std::remove_reference_t<T>>>::type;
+
+        template <typename T>
+        constexpr decltype(auto) unwrap_named_arg(T&& arg) noexcept
+        {
+            if constexpr (is_named_arg<std::remove_cv_t<std::remove_reference_t<T>>>::value)
+                return std::forward<unwrap_named_t<T>>(arg.value);
+            else
+                return std::forward<T>(arg);
+        }
+
+        template <typename Char, typename Traits, typename T>
+        constexpr std::basic_string_view<Char, Traits> named_arg_name(const T& arg) noexcept
+        {
+            if constexpr (is_named_arg<T>::value)
+            {
+                if constexpr (std::is_same_v<decltype(arg.name), std::basic_string_view<Char>>)
+                    return { arg.name.data(), arg.name.length() };
+                else
+                    return {};
+            }
+            else
+            {
+                return {};
+            }
+        }
+
         template <typename Int, typename Char, typename Traits>
         constexpr Int stou(std::basic_string_view<Char, Traits> str) noexcept
         {
@@ -186,6 +707,19 @@ namespace sf
         {
             return static_cast<std::ios_base::fmtflags>(0);
         }
+        template <io_state IOState, typename Char, typename Traits, long Ext>
+        std::ios_base::fmtflags stream_setf_x(stream_t<IOState, Char, Traits>& stream, int)
+        {
+            stream.iword(format_ext::index) |= Ext;
+            return static_cast<std::ios_base::fmtflags>(0);
+        }
+        template <io_state IOState, typename Char, typename Traits, long Ext, int Shift>
+        std::ios_base::fmtflags stream_setf_n(stream_t<IOState, Char, Traits>& stream, int fmtf)
+        {
+            stream.iword(format_ext::index) |= Ext;
+            format_ext::set_field(stream, Shift, fmtf);
+            return static_cast<std::ios_base::fmtflags>(0);
+        }
         template <io_state IOState, typename Char, typename Traits, std::ios_base::fmtflags Flag, std::ios_base::fmtflags Base>
         std::ios_base::fmtflags stream_setf_p(stream_t<IOState, Char, Traits>& stream, int fmtf)
         {
@@ -207,12 +741,49 @@ namespace sf
                 { Char{ 'r' }, stream_setf_w<IOState, Char, Traits, std::ios_base::right, std::ios_base::adjustfield, Char{ ' ' }> },
                 { Char{ 'i' }, stream_setf_w<IOState, Char, Traits, std::ios_base::internal, std::ios_base::adjustfield, Char{ ' ' }> },
                 { Char{ 'b' }, stream_setf_f<IOState, Char, Traits, std::ios_base::boolalpha> },
+                { Char{ 'c' }, stream_setf_x<IOState, Char, Traits, format_ext::locale_free> },
                 { Char{ 'u' }, stream_setf_f<IOState, Char, Traits, std::ios_base::uppercase> },
                 { Char{ 's' }, stream_setf_f<IOState, Char, Traits, std::ios_base::showbase> },
-                { Char{ 'g' }, stream_setf<IOState, Char, Traits> }
+                { Char{ 'g' }, stream_setf<IOState, Char, Traits> },
+                { Char{ 'h' }, stream_setf_n<IOState, Char, Traits, format_ext::hexdump, format_ext::hex_line_shift> },
+                { Char{ 'w' }, stream_setf_n<IOState, Char, Traits, 0, format_ext::hex_group_shift> },
+                { Char{ 'a' }, stream_setf_x<IOState, Char, Traits, format_ext::hex_ascii> },
+                { Char{ 'p' }, stream_setf_x<IOState, Char, Traits, format_ext::hex_offset> },
+                { Char{ 't' }, stream_setf_x<IOState, Char, Traits, format_ext::display_width> }
             };
         };
 
+        //Split the flags of a spec at the commas outside brackets, as in "[sep=,]", and call
+        //f(flag, number) for each one followed by nothing or digits. The others, like "iso", are
+        //left to formatters. fixed_sprint parses its flags with it too.
+        template <typename Char, typename Traits, typename F>
+        constexpr void format_flags_walk(std::basic_string_view<Char, Traits> fmts, F&& f)
+        {
+            using size_type = typename std::basic_string_view<Char, Traits>::size_type;
+            const size_type length = fmts.length();
+            size_type offset = 0;
+            size_type depth = 0;
+            for (size_type index = 0; index <= length; index++)
+            {
+                if (index < length && Traits::eq(fmts[index], Char{ '[' }))
+                    depth++;
+                else if (index < length && depth > 0 && Traits::eq(fmts[index], Char{ ']' }))
+                    depth--;
+                else if (index == length || (depth == 0 && Traits::eq(fmts[index], Char{ ',' })))
+                {
+                    if (index > offset)
+                    {
+                        bool numeric = true;
+                        for (size_type i = offset + 1; i < index; i++)
+                            numeric = numeric && is_digit(fmts[i]);
+                        if (numeric)
+                            f(fmts[offset], index > offset + 1 ? stou<int, Char, Traits>(fmts.substr(offset + 1, index - offset - 1)) : 0);
+                    }
+                    offset = index + 1;
+                }
+            }
+        }
+
         template <io_state IOState, typename Char, typename Traits>
         class format_arg_io
         {
@@ -229,36 +800,118 @@ namespace sf
 
         public:
             constexpr format_arg_io(arg_type& ori, string_view_type fmts) noexcept : ori(ori), fmts(fmts) {}
-            constexpr stream_type& operator()(stream_type& stream)
+            stream_type& operator()(stream_type& stream)
             {
-                std::ios_base::fmtflags oldf{};
-                int_type length = fmts.length();
-                int_type offset = 0, index = 0;
-                for (; index <= length; index++)
+                const std::ios_base::fmtflags oldf = stream.flags();
+                const Char oldfill = stream.fill();
+                const std::streamsize oldprec = stream.precision();
+                const long oldext = stream.iword(format_ext::index);
+                const format_spec::scope spec(stream, fmts);
+                format_flags_walk(fmts, [&](Char fmtc, int fmtf) {
+                    auto it = fsetf_type::methods.find(fmtc);
+                    if (it != fsetf_type::methods.end())
+                    {
+                        (it->second)(stream, fmtf);
+                    }
+                });
+                ori(stream);
+                stream.flags(oldf);
+                stream.fill(oldfill);
+                stream.precision(oldprec);
+                stream.iword(format_ext::index) = oldext;
+                return stream;
+            }
+        };
+
+        //Split a format string into literals and fields, for every engine. literal(text) gets the
+        //text between fields, including escaped braces and fields of missing arguments, and
+        //field(index, spec, has_spec) the fields of the count arguments, named by names if any.
+        template <typename Char, typename Traits, typename Literal, typename Field>
+        constexpr void format_walk(std::basic_string_view<Char, Traits> fmt, std::size_t count, const std::basic_string_view<Char, Traits>* names, Literal&& literal, Field&& field)
+        {
+            using size_type = typename std::basic_string_view<Char, Traits>::size_type;
+            size_type offset = 0, index = 0;
+            const size_type length = fmt.length();
+            bool in_number = false;
+            std::size_t arg_index = 0;
+            while (offset < length)
+            {
+                if (!in_number)
                 {
-                    if (index == length || Traits::eq(fmts[index], Char{ ',' }))
+                    size_type off = offset;
+                    for (index = offset; index < length; index++)
                     {
-                        Char fmtc = fmts[offset];
-                        int fmtf = 0;
-                        int_type len = index - offset - 1;
-                        if (len > 0)
+                        if (Traits::eq(fmt[index], Char{ '{' }))
+                        {
+                            index++;
+                            if (!(index < length && Traits::eq(fmt[index], Char{ '{' })))
+                            {
+                                in_number = true;
+                                index--;
+                            }
+                        }
+                        else if (Traits::eq(fmt[index], Char{ '}' }))
                         {
-                            fmtf = stou<int, Char, Traits>(fmts.substr(offset + 1, len));
+                            index++;
+                            if (!(index < length && Traits::eq(fmt[index], Char{ '}' })))
+                            {
+                                index--;
+                                continue;
+                            }
                         }
-                        auto it = fsetf_type::methods.find(fmtc);
-                        if (it != fsetf_type::methods.end())
+                        else
                         {
-                            oldf |= (it->second)(stream, fmtf);
+                            continue;
                         }
+                        break;
+                    }
+                    size_type len = index - offset;
+                    offset = index + 1;
+                    if (len > 0)
+                        literal(fmt.substr(off, len));
+                }
+                else
+                {
+                    for (index = offset; index < length; index++)
+                    {
+                        if (Traits::eq(fmt[index], Char{ '}' }))
+                            break;
+                    }
+                    if (index == length)
+                    {
+                        literal(fmt.substr(offset - 1));
                         offset = index + 1;
+                        continue;
                     }
+                    in_number = false;
+                    size_type ci = offset;
+                    while (ci < index && !Traits::eq(fmt[ci], Char{ ':' }))
+                        ci++;
+                    if (ci > offset)
+                    {
+                        const std::basic_string_view<Char, Traits> id = fmt.substr(offset, ci - offset);
+                        if (is_digit(id[0]))
+                        {
+                            arg_index = stou<std::size_t, Char, Traits>(id);
+                        }
+                        else
+                        {
+                            arg_index = 0;
+                            while (arg_index < count && !(names && names[arg_index] == id))
+                                arg_index++;
+                        }
+                    }
+                    if (arg_index >= count)
+                        literal(fmt.substr(offset - 1, index - offset + 2));
+                    else if (index == ci)
+                        field(arg_index, std::basic_string_view<Char, Traits>{}, false);
+                    else
+                        field(arg_index, fmt.substr(ci + 1, index - ci - 1), true);
+                    offset = index + 1;
+                    arg_index++;
                 }
-                ori(stream);
-                if (oldf)
-                    stream.setf(oldf);
-                return stream;
             }
-        };
+        }
 
         //A pack of format string and arguments.
         template <io_state IOState, typename Char, typename Traits>
@@ -275,121 +928,354 @@ namespace sf
         private:
             string_view_type fmt;
             arg_list_type args;
+            const string_view_type* names;
 
         public:
-            constexpr format_string_view(string_view_type fmt, arg_list_type&& args) noexcept : fmt(fmt), args(std::move(args))
+            constexpr format_string_view(string_view_type fmt, arg_list_type&& args, const string_view_type* names = nullptr) noexcept : fmt(fmt), args(std::move(args)), names(names)
             {
             }
-            constexpr stream_type& operator()(stream_type& stream)
+            stream_type& operator()(stream_type& stream)
             {
-                int_type offset = 0, index = 0;
-                const int_type length = fmt.length();
-                bool in_number = false;
-                std::size_t arg_index = 0;
-                while (offset < length)
-                {
-                    if (!in_number)
-                    {
-                        int_type off = offset;
-                        for (index = offset; index < length; index++)
-                        {
-                            if (Traits::eq(fmt[index], Char{ '{' }))
-                            {
-                                index++;
-                                if (!(index < length && Traits::eq(fmt[index], Char{ '{' })))
-                                {
-                                    in_number = true;
-                                    index--;
-                                }
-                            }
-                            else if (Traits::eq(fmt[index], Char{ '}' }))
-                            {
-                                index++;
-                                if (!(index < length && Traits::eq(fmt[index], Char{ '}' })))
-                                {
-                                    index--;
-                                    continue;
-                                }
-                            }
-                            else
-                            {
-                                continue;
-                            }
-                            break;
-                        }
-                        int_type len = index - offset;
-                        offset = index + 1;
-                        if (len <= 0)
-                            continue;
-                        string_view_io_type{ fmt.substr(off, len) }(stream);
-                    }
-                    else
-                    {
-                        for (index = offset; index < length; index++)
-                        {
-                            if (Traits::eq(fmt[index], Char{ '}' }))
-                                break;
-                        }
-                        if (index == length)
-                        {
-                            string_view_io_type(fmt.substr(offset - 1))(stream);
-                            offset = index + 1;
-                        }
+                format_walk(
+                    fmt, args.size(), names,
+                    [&](string_view_type text) { string_view_io_type{ std::move(text) }(stream); },
+                    [&](std::size_t index, string_view_type spec, bool has_spec) {
+                        if (has_spec)
+                            format_arg_io<IOState, Char, Traits>{ args[index], spec }(stream);
                         else
-                        {
-                            in_number = false;
-                            int_type ci;
-                            for (ci = offset; ci < index; ci++)
-                            {
-                                if (Traits::eq(fmt[ci], Char{ ':' }))
-                                {
-                                    break;
-                                }
-                            }
-                            if (ci > offset)
-                            {
-                                arg_index = stou<std::size_t, Char, Traits>(fmt.substr(offset, ci - offset));
-                            }
-                            if (arg_index >= args.size())
-                            {
-                                string_view_io_type{ fmt.substr(offset - 1, index - offset + 2) }(stream);
-                            }
-                            else if (index == ci)
-                            {
-                                args[arg_index](stream);
-                            }
-                            else
-                            {
-                                format_arg_io<IOState, Char, Traits>{ args[arg_index], fmt.substr(ci + 1, index - ci - 1) }(stream);
-                            }
-                            offset = index + 1;
-                            arg_index++;
-                        }
-                    }
-                }
+                            args[index](stream);
+                    });
                 return stream;
             }
         };
 
+#ifdef SF_ENABLE_STATS
+        //Counters of a format string in a thread. Only the owner thread adds to them.
+        struct stats_counters
+        {
+            std::atomic<std::uint64_t> calls{ 0 };
+            std::atomic<std::uint64_t> bytes{ 0 };
+            std::atomic<std::uint64_t> nanoseconds{ 0 };
+            std::atomic<std::uint64_t> failures{ 0 };
+        };
+
+        struct stats_site
+        {
+            bool input;
+            std::string format;
+            stats_counters counters;
+
+            stats_site(bool input, std::string&& format) : input(input), format(std::move(format)) {}
+        };
+
+        //Owns the counters of all threads, so they outlive the threads.
+        class stats_registry
+        {
+        private:
+            std::mutex mutex;
+            std::deque<stats_site> sites;
+
+        public:
+            static stats_registry& instance()
+            {
+                static stats_registry registry;
+                return registry;
+            }
+
+            stats_counters& add(bool input, std::string&& format)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                return sites.emplace_back(input, std::move(format)).counters;
+            }
+
+            template <typename F>
+            void for_each(F&& f)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                for (stats_site& site : sites)
+                    f(site);
+            }
+        };
+
+        //Format strings are identified by their text, so formats built for each call share one entry.
+        //A call with the same format string as last time at that address skips the hash.
+        template <io_state IOState, typename Char, typename Traits>
+        stats_counters& stats_lookup(std::basic_string_view<Char, Traits> fmt)
+        {
+            struct cached
+            {
+                std::basic_string<Char, Traits> text;
+                stats_counters* counters;
+            };
+            thread_local std::unordered_map<const Char*, cached> by_address;
+            thread_local std::unordered_multimap<std::uint64_t, cached> by_text;
+            auto found = by_address.find(fmt.data());
+            if (found != by_address.end() && fmt == found->second.text)
+                return *found->second.counters;
+            //FNV-1a
+            std::uint64_t hash = 14695981039346656037ull;
+            for (Char c : fmt)
+                hash = (hash ^ static_cast<std::uint64_t>(Traits::to_int_type(c))) * 1099511628211ull;
+            stats_counters* counters = nullptr;
+            auto range = by_text.equal_range(hash);
+            for (auto it = range.first; it != range.second; ++it)
+            {
+                if (fmt == it->second.text)
+                {
+                    counters = it->second.counters;
+                    break;
+                }
+            }
+            if (!counters)
+            {
+                std::string text;
+                if constexpr (std::is_same_v<Char, char>)
+                    text.assign(fmt.data(), fmt.length());
+                else
+                    text = to_utf8(fmt);
+                counters = &stats_registry::instance().add(IOState == input, std::move(text));
+                by_text.emplace(hash, cached{ std::basic_string<Char, Traits>(fmt), counters });
+            }
+            //Formats built on the heap take ever new addresses, so forget them now and then.
+            if (by_address.size() >= 4096)
+                by_address.clear();
+            by_address.insert_or_assign(fmt.data(), cached{ std::basic_string<Char, Traits>(fmt), counters });
+            return *counters;
+        }
+
+        //Forwards to the stream buffer of the stream being formatted, and counts the characters
+        //written or consumed.
+        template <typename Char, typename Traits>
+        class stats_streambuf : public std::basic_streambuf<Char, Traits>
+        {
+        private:
+            using int_type = typename Traits::int_type;
+
+        public:
+            std::basic_streambuf<Char, Traits>* target = nullptr;
+            std::uint64_t count = 0;
+
+        protected:
+            int_type overflow(int_type c) override
+            {
+                if (Traits::eq_int_type(c, Traits::eof()))
+                    return Traits::not_eof(c);
+                int_type result = target->sputc(Traits::to_char_type(c));
+                if (!Traits::eq_int_type(result, Traits::eof()))
+                    count++;
+                return result;
+            }
+            std::streamsize xsputn(const Char* s, std::streamsize n) override
+            {
+                std::streamsize written = target->sputn(s, n);
+                count += static_cast<std::uint64_t>(written);
+                return written;
+            }
+            int sync() override { return target->pubsync(); }
+
+            int_type underflow() override { return target->sgetc(); }
+            int_type uflow() override
+            {
+                int_type c = target->sbumpc();
+                if (!Traits::eq_int_type(c, Traits::eof()))
+                    count++;
+                return c;
+            }
+            std::streamsize xsgetn(Char* s, std::streamsize n) override
+            {
+                std::streamsize read = target->sgetn(s, n);
+                count += static_cast<std::uint64_t>(read);
+                return read;
+            }
+            int_type pbackfail(int_type c) override
+            {
+                int_type result = Traits::eq_int_type(c, Traits::eof()) ? target->sungetc() : target->sputbackc(Traits::to_char_type(c));
+                if (!Traits::eq_int_type(result, Traits::eof()))
+                    count--;
+                return result;
+            }
+            std::streamsize showmanyc() override { return target->in_avail(); }
+        };
+
+        //A stream of this thread over a stats_streambuf. It takes the format state of the stream
+        //being formatted and gives it back, so that stream and its buffer are never changed, and
+        //can be shared with other threads.
+        template <io_state IOState, typename Char, typename Traits>
+        class stats_scope
+        {
+        private:
+            struct counted
+            {
+                stats_streambuf<Char, Traits> buf;
+                stream_t<IOState, Char, Traits> stream{ &buf };
+            };
+
+            //One stream for each level of nesting, e.g. a print in an operator<< of an argument.
+            static std::vector<std::unique_ptr<counted>>& streams()
+            {
+                static thread_local std::vector<std::unique_ptr<counted>> list;
+                return list;
+            }
+            static std::size_t& depth()
+            {
+                static thread_local std::size_t value = 0;
+                return value;
+            }
+
+            stream_t<IOState, Char, Traits>& from;
+            counted& local;
+
+            static counted& take()
+            {
+                auto& list = streams();
+                if (depth() == list.size())
+                    list.push_back(std::make_unique<counted>());
+                return *list[depth()++];
+            }
+
+        public:
+            stats_scope(stream_t<IOState, Char, Traits>& from) : from(from), local(take())
+            {
+                auto& to = local.stream;
+                local.buf.target = from.rdbuf();
+                local.buf.count = 0;
+                to.exceptions(std::ios_base::goodbit);
+                to.clear(from.rdstate());
+                to.flags(from.flags());
+                to.precision(from.precision());
+                to.width(from.width());
+                to.fill(from.fill());
+                to.tie(from.tie());
+                to.iword(format_ext::index) = from.iword(format_ext::index);
+                if (to.getloc() != from.getloc())
+                    to.imbue(from.getloc());
+                to.exceptions(from.exceptions() & ~from.rdstate());
+            }
+
+            ~stats_scope()
+            {
+                auto& to = local.stream;
+                from.flags(to.flags());
+                from.precision(to.precision());
+                from.width(to.width());
+                from.fill(to.fill());
+                from.iword(format_ext::index) = to.iword(format_ext::index);
+                //The stream of this thread has thrown for the bits in the mask already.
+                from.setstate(to.rdstate() & ~from.exceptions());
+                depth()--;
+            }
+
+            stream_t<IOState, Char, Traits>& stream() noexcept { return local.stream; }
+            std::uint64_t count() const noexcept { return local.buf.count; }
+        };
+
         template <io_state IOState, typename Char, typename Traits>
-        constexpr stream_t<IOState, Char, Traits>& vformat(stream_t<IOState, Char, Traits>& stream, std::basic_string_view<Char, Traits> fmt, arg_list_t<stream_t<IOState, Char, Traits>>&& args)
+        stream_t<IOState, Char, Traits>& stats_format(stream_t<IOState, Char, Traits>& stream, std::basic_string_view<Char, Traits> fmt, arg_list_t<stream_t<IOState, Char, Traits>>&& args, const std::basic_string_view<Char, Traits>* names)
         {
-            return format_string_view<IOState, Char, Traits>{ fmt, std::move(args) }(stream);
+            stats_counters& counters = stats_lookup<IOState, Char, Traits>(fmt);
+            const auto start = std::chrono::steady_clock::now();
+            std::uint64_t bytes = 0;
+            bool failed = false;
+            if (stream.rdbuf())
+            {
+                stats_scope<IOState, Char, Traits> scope(stream);
+                format_string_view<IOState, Char, Traits>{ fmt, std::move(args), names }(scope.stream());
+                bytes = scope.count();
+                failed = scope.stream().fail();
+            }
+            else
+            {
+                format_string_view<IOState, Char, Traits>{ fmt, std::move(args), names }(stream);
+                failed = stream.fail();
+            }
+            const auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+            counters.calls.fetch_add(1, std::memory_order_relaxed);
+            counters.bytes.fetch_add(bytes, std::memory_order_relaxed);
+            counters.nanoseconds.fetch_add(static_cast<std::uint64_t>(time), std::memory_order_relaxed);
+            if (failed)
+                counters.failures.fetch_add(1, std::memory_order_relaxed);
+            return stream;
+        }
+#endif // SF_ENABLE_STATS
+
+        template <io_state IOState, typename Char, typename Traits>
+        stream_t<IOState, Char, Traits>& vformat(stream_t<IOState, Char, Traits>& stream, std::basic_string_view<Char, Traits> fmt, arg_list_t<stream_t<IOState, Char, Traits>>&& args, const std::basic_string_view<Char, Traits>* names = nullptr)
+        {
+#ifdef SF_ENABLE_STATS
+            return stats_format<IOState, Char, Traits>(stream, fmt, std::move(args), names);
+#else
+            return format_string_view<IOState, Char, Traits>{ fmt, std::move(args), names }(stream);
+#endif // SF_ENABLE_STATS
         }
 
         template <io_state IOState, typename Char, typename Traits, typename... Args>
         constexpr stream_t<IOState, Char, Traits>& format(stream_t<IOState, Char, Traits>& stream, std::basic_string_view<Char, Traits> fmt, Args&&... args)
         {
-            return vformat<IOState, Char, Traits>(stream, fmt, arg_list_t<stream_t<IOState, Char, Traits>>{ arg_io<IOState, Args, Char, Traits>(std::forward<Args>(args))... });
+            if constexpr (has_named_arg_v<Args...>)
+            {
+                const std::basic_string_view<Char, Traits> names[] = { named_arg_name<Char, Traits>(args)... };
+                return vformat<IOState, Char, Traits>(stream, fmt, arg_list_t<stream_t<IOState, Char, Traits>>{ arg_io<IOState, unwrap_named_t<Args>, Char, Traits>(unwrap_named_arg(std::forward<Args>(args)))... }, names);
+            }
+            else
+            {
+                return vformat<IOState, Char, Traits>(stream, fmt, arg_list_t<stream_t<IOState, Char, Traits>>{ arg_io<IOState, Args, Char, Traits>(std::forward<Args>(args))... });
+            }
         }
 
         template <io_state IOState, typename Char, typename Traits, typename T>
         constexpr stream_t<IOState, Char, Traits>& put(stream_t<IOState, Char, Traits>& stream, T&& arg)
         {
-            return arg_io<IOState, T, Char, Traits>{ std::forward<T>(arg) }(stream);
+            return arg_io<IOState, unwrap_named_t<T>, Char, Traits>{ unwrap_named_arg(std::forward<T>(arg)) }(stream);
         }
+
+#ifdef SF_USE_COMPILED
+        //The engine for char and wchar_t is instantiated in the library stream_format_compiled.
+        extern template class string_view_io<input, char, std::char_traits<char>>;
+        extern template class string_view_io<output, char, std::char_traits<char>>;
+        extern template class string_view_io<input, wchar_t, std::char_traits<wchar_t>>;
+        extern template class string_view_io<output, wchar_t, std::char_traits<wchar_t>>;
+
+        extern template struct format_setf<input, char, std::char_traits<char>>;
+        extern template struct format_setf<output, char, std::char_traits<char>>;
+        extern template struct format_setf<input, wchar_t, std::char_traits<wchar_t>>;
+        extern template struct format_setf<output, wchar_t, std::char_traits<wchar_t>>;
+
+        extern template class format_arg_io<input, char, std::char_traits<char>>;
+        extern template class format_arg_io<output, char, std::char_traits<char>>;
+        extern template class format_arg_io<input, wchar_t, std::char_traits<wchar_t>>;
+        extern template class format_arg_io<output, wchar_t, std::char_traits<wchar_t>>;
+
+        extern template class format_string_view<input, char, std::char_traits<char>>;
+        extern template class format_string_view<output, char, std::char_traits<char>>;
+        extern template class format_string_view<input, wchar_t, std::char_traits<wchar_t>>;
+        extern template class format_string_view<output, wchar_t, std::char_traits<wchar_t>>;
+
+        extern template std::istream& vformat<input, char, std::char_traits<char>>(std::istream&, std::string_view, arg_list_t<std::istream>&&, const std::string_view*);
+        extern template std::ostream& vformat<output, char, std::char_traits<char>>(std::ostream&, std::string_view, arg_list_t<std::ostream>&&, const std::string_view*);
+        extern template std::wistream& vformat<input, wchar_t, std::char_traits<wchar_t>>(std::wistream&, std::wstring_view, arg_list_t<std::wistream>&&, const std::wstring_view*);
+        extern template std::wostream& vformat<output, wchar_t, std::char_traits<wchar_t>>(std::wostream&, std::wstring_view, arg_list_t<std::wostream>&&, const std::wstring_view*);
+#endif // SF_USE_COMPILED
     } // namespace internal
 
+    //Wrap an argument with a name, which could be referred as {name} in the format string.
+    template <typename Char, typename T>
+    constexpr internal::named_arg<Char, T> arg(const Char* name, T&& value) noexcept(std::is_nothrow_constructible_v<T, T&&>)
+    {
+        return { name, std::forward<T>(value) };
+    }
+
+    //Manipulators to switch the locale-free fast path of a stream.
+    inline std::ios_base& locale_free(std::ios_base& stream)
+    {
+        stream.iword(internal::format_ext::index) |= internal::format_ext::locale_free;
+        return stream;
+    }
+    inline std::ios_base& locale_aware(std::ios_base& stream)
+    {
+        stream.iword(internal::format_ext::index) &= ~internal::format_ext::locale_free;
+        return stream;
+    }
+
     //template IO
     template <typename Char, typename Traits = std::char_traits<Char>, typename String, typename... Args, typename = std::enable_if_t<std::is_convertible_v<String, std::basic_string_view<Char, Traits>>>>
     constexpr std::basic_istream<Char, Traits>& scan(std::basic_istream<Char, Traits>& stream, String&& fmt, Args&&... args)
@@ -479,6 +1365,11 @@ namespace sf
     {
         return scan(std::wcin, fmt, std::forward<Args>(args)...);
     }
+    template <typename... Args>
+    constexpr std::wistream& wscan(std::wistream& stream, std::wstring_view fmt, Args&&... args)
+    {
+        return scan(stream, fmt, std::forward<Args>(args)...);
+    }
     template <typename T>
     constexpr std::wistream& wscan(T&& arg)
     {
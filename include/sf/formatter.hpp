@@ -0,0 +1,197 @@
+/**StreamFormat formatter.hpp
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2018-2020 Berrysoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+#ifndef SF_FORMATTER_HPP
+#define SF_FORMATTER_HPP
+
+#include <sf/utility.hpp>
+
+#include <ios>
+#include <istream>
+#include <iterator>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace sf
+{
+    //Specialize to print T without operator<<. A specialization provides
+    //  template <typename OutputIt> OutputIt format(const T& value, OutputIt out);
+    //and optionally
+    //  void parse(std::basic_string_view<Char> spec);
+    //  std::size_t size(const T& value);
+    template <typename T, typename Char = char>
+    struct formatter
+    {
+        formatter() = delete;
+    };
+
+    //Specialize to scan T without operator>>. A specialization provides
+    //  template <typename InputIt> bool scan(InputIt& first, InputIt last, T& value);
+    //and optionally
+    //  void parse(std::basic_string_view<Char> spec);
+    template <typename T, typename Char = char>
+    struct scanner
+    {
+        scanner() = delete;
+    };
+
+    namespace internal
+    {
+        template <typename T, typename Char>
+        inline constexpr bool has_formatter_v = std::is_default_constructible_v<formatter<T, Char>>;
+        template <typename T, typename Char>
+        inline constexpr bool has_scanner_v = std::is_default_constructible_v<scanner<T, Char>>;
+
+        template <typename F, typename Char, typename = void>
+        struct has_parse : std::false_type
+        {
+        };
+        template <typename F, typename Char>
+        struct has_parse<F, Char, std::void_t<decltype(std::declval<F&>().parse(std::declval<std::basic_string_view<Char>>()))>> : std::true_type
+        {
+        };
+
+        template <typename F, typename T, typename = void>
+        struct has_size : std::false_type
+        {
+        };
+        template <typename F, typename T>
+        struct has_size<F, T, std::void_t<decltype(std::declval<F&>().size(std::declval<const T&>()))>> : std::true_type
+        {
+        };
+
+        //The flag text after ':' of the argument being formatted, stored in a pword of the stream.
+        struct format_spec
+        {
+            inline static const int index = std::ios_base::xalloc();
+
+            //Sets the spec for the lifetime of the scope, also when formatting throws.
+            class scope
+            {
+            private:
+                std::ios_base& stream;
+                void* old;
+
+            public:
+                template <typename Char, typename Traits>
+                scope(std::ios_base& stream, const std::basic_string_view<Char, Traits>& spec) : stream(stream), old(stream.pword(index))
+                {
+                    stream.pword(index) = const_cast<std::basic_string_view<Char, Traits>*>(&spec);
+                }
+                ~scope() { stream.pword(index) = old; }
+
+                scope(const scope&) = delete;
+                scope& operator=(const scope&) = delete;
+            };
+
+            template <typename Char, typename Traits>
+            static std::basic_string_view<Char> get(std::ios_base& stream)
+            {
+                auto ptr = static_cast<const std::basic_string_view<Char, Traits>*>(stream.pword(index));
+                return ptr ? std::basic_string_view<Char>(ptr->data(), ptr->length()) : std::basic_string_view<Char>{};
+            }
+        };
+
+        template <typename F, typename Char, typename Traits>
+        void parse_spec(F& f, std::ios_base& stream)
+        {
+            if constexpr (has_parse<F, Char>::value)
+                f.parse(format_spec::get<Char, Traits>(stream));
+        }
+
+        template <typename Char, typename Traits>
+        void put_fill(std::basic_streambuf<Char, Traits>& buf, Char fill, std::streamsize count)
+        {
+            for (; count > 0; count--)
+                buf.sputc(fill);
+        }
+
+        //Print with formatter<T, Char>, padded to the width of the stream.
+        template <typename Char, typename Traits, typename T>
+        std::basic_ostream<Char, Traits>& put_formatted(std::basic_ostream<Char, Traits>& stream, const T& value)
+        {
+            typename std::basic_ostream<Char, Traits>::sentry ok(stream);
+            if (!ok)
+                return stream;
+            formatter<T, Char> f;
+            parse_spec<formatter<T, Char>, Char, Traits>(f, stream);
+            const std::streamsize width = stream.width(0);
+            const bool left = (stream.flags() & std::ios_base::adjustfield) == std::ios_base::left;
+            std::basic_streambuf<Char, Traits>& buf = *stream.rdbuf();
+            if (width <= 0)
+            {
+                if (f.format(value, std::ostreambuf_iterator<Char, Traits>(&buf)).failed())
+                    stream.setstate(std::ios_base::badbit);
+            }
+            else if constexpr (has_size<formatter<T, Char>, T>::value)
+            {
+                //The size is known, so the padding and the text are written straight to the buffer.
+                const std::streamsize pad = width - static_cast<std::streamsize>(f.size(value));
+                if (!left)
+                    put_fill(buf, stream.fill(), pad);
+                if (f.format(value, std::ostreambuf_iterator<Char, Traits>(&buf)).failed())
+                    stream.setstate(std::ios_base::badbit);
+                if (left)
+                    put_fill(buf, stream.fill(), pad);
+            }
+            else
+            {
+                std::basic_string<Char, Traits> text;
+                f.format(value, std::back_inserter(text));
+                const std::streamsize pad = width - static_cast<std::streamsize>(text.length());
+                if (!left)
+                    put_fill(buf, stream.fill(), pad);
+                if (buf.sputn(text.data(), static_cast<std::streamsize>(text.length())) != static_cast<std::streamsize>(text.length()))
+                    stream.setstate(std::ios_base::badbit);
+                if (left)
+                    put_fill(buf, stream.fill(), pad);
+            }
+            return stream;
+        }
+
+        //Scan with scanner<T, Char>, after skipping spaces as operator>> does.
+        template <typename Char, typename Traits, typename T>
+        std::basic_istream<Char, Traits>& get_scanned(std::basic_istream<Char, Traits>& stream, T& value)
+        {
+            typename std::basic_istream<Char, Traits>::sentry ok(stream);
+            if (!ok)
+                return stream;
+            scanner<T, Char> s;
+            parse_spec<scanner<T, Char>, Char, Traits>(s, stream);
+            std::istreambuf_iterator<Char, Traits> first(stream), last;
+            std::ios_base::iostate state = std::ios_base::goodbit;
+            if (!s.scan(first, last, value))
+                state |= std::ios_base::failbit;
+            if (first == last)
+                state |= std::ios_base::eofbit;
+            stream.setstate(state);
+            return stream;
+        }
+    } // namespace internal
+} // namespace sf
+
+#endif // !SF_FORMATTER_HPP
@@ -0,0 +1,264 @@
+/**StreamFormat hexdump.hpp
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2018-2020 Berrysoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+#ifndef SF_HEXDUMP_HPP
+#define SF_HEXDUMP_HPP
+
+#include <sf/utility.hpp>
+
+#include <cstddef>
+#include <iterator>
+#include <ostream>
+#include <sf/charconv.hpp>
+#include <type_traits>
+
+#ifdef SF_HAS_SSE2
+    #include <emmintrin.h>
+#endif // SF_HAS_SSE2
+
+namespace sf
+{
+    namespace internal
+    {
+        //Elements which are dumped as bytes.
+        template <typename T>
+        inline constexpr bool is_byte_v = std::is_same_v<T, char> || std::is_same_v<T, signed char> || std::is_same_v<T, unsigned char> || std::is_same_v<T, std::byte>
+#ifdef __cpp_char8_t
+                                          || std::is_same_v<T, char8_t>
+#endif // __cpp_char8_t
+            ;
+
+        //Contiguous containers of bytes, such as std::vector<std::byte> or std::string.
+        template <typename T, typename = void>
+        struct is_byte_range : std::false_type
+        {
+        };
+        template <typename T>
+        struct is_byte_range<T, std::void_t<decltype(std::data(std::declval<const T&>())), decltype(std::size(std::declval<const T&>()))>>
+            : std::bool_constant<std::is_class_v<T> && std::is_pointer_v<decltype(std::data(std::declval<const T&>()))> && is_byte_v<std::remove_cv_t<std::remove_pointer_t<decltype(std::data(std::declval<const T&>()))>>>>
+        {
+        };
+        template <typename T>
+        inline constexpr bool is_byte_range_v = is_byte_range<T>::value;
+
+        template <typename T, typename Char, typename Traits, typename = void>
+        struct is_streamable : std::false_type
+        {
+        };
+        template <typename T, typename Char, typename Traits>
+        struct is_streamable<T, Char, Traits, std::void_t<decltype(std::declval<std::basic_ostream<Char, Traits>&>() << std::declval<const T&>())>> : std::true_type
+        {
+        };
+
+        //A range of raw memory.
+        class byte_view
+        {
+        private:
+            const unsigned char* ptr;
+            std::size_t len;
+
+        public:
+            constexpr byte_view(const void* ptr, std::size_t len) noexcept : ptr(static_cast<const unsigned char*>(ptr)), len(len) {}
+            constexpr const unsigned char* data() const noexcept { return ptr; }
+            constexpr std::size_t size() const noexcept { return len; }
+        };
+
+        struct hexdump_options
+        {
+            //Bytes per line, or 0 for one line.
+            std::size_t line;
+            //Bytes per group separated by a space, or 0 for no spaces.
+            std::size_t group;
+            bool ascii;
+            bool offset;
+            bool upper;
+        };
+
+        //Write two hex digits for each of 16 bytes.
+        inline void hex_block(const unsigned char* in, char* out, bool upper) noexcept
+        {
+#ifdef SF_HAS_SSE2
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+            const __m128i mask = _mm_set1_epi8(0x0f);
+            const __m128i nine = _mm_set1_epi8(9);
+            const __m128i zero = _mm_set1_epi8('0');
+            const __m128i letter = _mm_set1_epi8(upper ? 'A' - '0' - 10 : 'a' - '0' - 10);
+            __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), mask);
+            __m128i lo = _mm_and_si128(v, mask);
+            hi = _mm_add_epi8(_mm_add_epi8(hi, zero), _mm_and_si128(_mm_cmpgt_epi8(hi, nine), letter));
+            lo = _mm_add_epi8(_mm_add_epi8(lo, zero), _mm_and_si128(_mm_cmpgt_epi8(lo, nine), letter));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(hi, lo));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), _mm_unpackhi_epi8(hi, lo));
+#else
+            const char* digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+            for (int i = 0; i < 16; i++)
+            {
+                out[2 * i] = digits[in[i] >> 4];
+                out[2 * i + 1] = digits[in[i] & 0xf];
+            }
+#endif // SF_HAS_SSE2
+        }
+
+        inline void hex_bytes(const unsigned char* in, std::size_t len, char* out, bool upper) noexcept
+        {
+            std::size_t i = 0;
+            for (; i + 16 <= len; i += 16)
+                hex_block(in + i, out + 2 * i, upper);
+            const char* digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+            for (; i < len; i++)
+            {
+                out[2 * i] = digits[in[i] >> 4];
+                out[2 * i + 1] = digits[in[i] & 0xf];
+            }
+        }
+
+        //Characters of the hex column for count bytes.
+        constexpr std::size_t hex_width(std::size_t count, std::size_t group) noexcept
+        {
+            return count == 0 ? 0 : 2 * count + (group ? (count - 1) / group : 0);
+        }
+
+        //Collects output in blocks before writing them to a stream buffer.
+        template <typename Char, typename Traits>
+        class hexdump_writer
+        {
+        private:
+            std::basic_streambuf<Char, Traits>* buf;
+            Char out[512];
+            std::size_t used;
+            bool ok;
+
+        public:
+            hexdump_writer(std::basic_streambuf<Char, Traits>* buf) noexcept : buf(buf), used(0), ok(true) {}
+
+            void flush()
+            {
+                if (used && ok)
+                    ok = buf->sputn(out, static_cast<std::streamsize>(used)) == static_cast<std::streamsize>(used);
+                used = 0;
+            }
+            //Make room for n characters, n <= 512, and return where to write them.
+            Char* space(std::size_t n)
+            {
+                if (used + n > sizeof(out) / sizeof(Char))
+                    flush();
+                return out + used;
+            }
+            //Commit n characters written to space().
+            void advance(std::size_t n) noexcept { used += n; }
+            void put(Char c)
+            {
+                *space(1) = c;
+                advance(1);
+            }
+            bool good() const noexcept { return ok; }
+        };
+
+        template <typename Char, typename Traits>
+        std::basic_ostream<Char, Traits>& put_hexdump(std::basic_ostream<Char, Traits>& stream, const unsigned char* data, std::size_t size, const hexdump_options& options)
+        {
+            typename std::basic_ostream<Char, Traits>::sentry sentry(stream);
+            if (!sentry)
+                return stream;
+            hexdump_writer<Char, Traits> writer(stream.rdbuf());
+            const std::size_t line = options.line ? options.line : size;
+            char hex[32];
+            for (std::size_t start = 0; start < size; start += line)
+            {
+                const std::size_t count = size - start < line ? size - start : line;
+                if (start > 0)
+                    writer.put(Char{ '\n' });
+                if (options.offset)
+                {
+                    //At least 8 digits, more for offsets from 4 GiB.
+                    Char digits[2 * sizeof(std::size_t)];
+                    Char* const end = digits + 2 * sizeof(std::size_t);
+                    Char* first = format_uint(end, start, 16, options.upper);
+                    const std::size_t length = static_cast<std::size_t>(end - first);
+                    const std::size_t width = length > 8 ? length : 8;
+                    Char* p = writer.space(width + 2);
+                    std::size_t i = 0;
+                    for (; i < width - length; i++)
+                        p[i] = Char{ '0' };
+                    for (; first != end; ++first)
+                        p[i++] = *first;
+                    p[width] = p[width + 1] = Char{ ' ' };
+                    writer.advance(width + 2);
+                }
+                for (std::size_t i = 0; i < count; i += 16)
+                {
+                    const std::size_t n = count - i < 16 ? count - i : 16;
+                    hex_bytes(data + start + i, n, hex, options.upper);
+                    if constexpr (std::is_same_v<Char, char>)
+                    {
+                        if (options.group == 0)
+                        {
+                            Traits::copy(writer.space(2 * n), hex, 2 * n);
+                            writer.advance(2 * n);
+                            continue;
+                        }
+                    }
+                    for (std::size_t j = 0; j < n; j++)
+                    {
+                        const std::size_t k = i + j;
+                        Char* p = writer.space(3);
+                        std::size_t m = 0;
+                        if (k > 0 && options.group && k % options.group == 0)
+                            p[m++] = Char{ ' ' };
+                        p[m++] = static_cast<Char>(hex[2 * j]);
+                        p[m++] = static_cast<Char>(hex[2 * j + 1]);
+                        writer.advance(m);
+                    }
+                }
+                if (options.ascii)
+                {
+                    std::size_t pad = hex_width(line, options.group) - hex_width(count, options.group) + 2;
+                    for (; pad > 0; pad--)
+                        writer.put(Char{ ' ' });
+                    writer.put(Char{ '|' });
+                    for (std::size_t i = 0; i < count; i++)
+                    {
+                        const unsigned char c = data[start + i];
+                        writer.put(c >= 0x20 && c < 0x7f ? static_cast<Char>(c) : Char{ '.' });
+                    }
+                    writer.put(Char{ '|' });
+                }
+            }
+            writer.flush();
+            stream.width(0);
+            if (!writer.good())
+                stream.setstate(std::ios_base::badbit);
+            return stream;
+        }
+    } // namespace internal
+
+    //Refer to raw memory, to print it as a hexdump.
+    inline internal::byte_view make_bytes(const void* data, std::size_t size) noexcept
+    {
+        return internal::byte_view(data, size);
+    }
+} // namespace sf
+
+#endif // !SF_HEXDUMP_HPP
@@ -0,0 +1,214 @@
+/**StreamFormat incremental_scanner.hpp
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2018-2020 Berrysoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+#ifndef SF_INCREMENTAL_SCANNER_HPP
+#define SF_INCREMENTAL_SCANNER_HPP
+
+#include <sf/utility.hpp>
+
+#include <functional>
+#include <sf/scan_pattern.hpp>
+#include <string>
+#include <string_view>
+#include <tuple>
+
+#ifdef __cpp_impl_coroutine
+    #include <coroutine>
+#endif // __cpp_impl_coroutine
+
+namespace sf
+{
+    //Scans records of a format from input which arrives in chunks.
+    template <typename Char, typename Traits = std::char_traits<Char>>
+    class basic_incremental_scanner
+    {
+    public:
+        using string_type = std::basic_string<Char, Traits>;
+        using string_view_type = std::basic_string_view<Char, Traits>;
+
+    private:
+        scan_pattern<Char, Traits> pattern;
+        string_type buffer;
+        //The start of the current record in the buffer.
+        std::size_t start;
+        scan_progress progress;
+        scan_result last_result;
+        scan_status last_status;
+        bool ended;
+#ifdef __cpp_impl_coroutine
+        std::coroutine_handle<> waiting;
+        std::function<bool()> retry;
+#endif // __cpp_impl_coroutine
+
+        void append(string_view_type chunk)
+        {
+            bool moved = false;
+            if (start > 0 && start >= buffer.length() / 2)
+            {
+                buffer.erase(0, start);
+                progress.position -= start;
+                start = 0;
+                moved = true;
+            }
+            const Char* data = buffer.data();
+            buffer.append(chunk);
+            //Fields already stored may refer to the old storage, so scan the record again.
+            if (moved || buffer.data() != data)
+                progress = { 0, start };
+        }
+
+        bool only_spaces() const noexcept
+        {
+            for (std::size_t i = start; i < buffer.length(); i++)
+            {
+                if (!internal::is_space(buffer[i]))
+                    return false;
+            }
+            return true;
+        }
+
+        void wake()
+        {
+#ifdef __cpp_impl_coroutine
+            if (waiting && (retry() || ended))
+            {
+                std::coroutine_handle<> handle = waiting;
+                waiting = nullptr;
+                retry = nullptr;
+                handle.resume();
+            }
+#endif // __cpp_impl_coroutine
+        }
+
+    public:
+        explicit basic_incremental_scanner(string_view_type fmt) : pattern(fmt), start(0), progress{ 0, 0 }, last_result{ scan_result::npos, 0, false }, last_status(scan_status::need_more), ended(false) {}
+        basic_incremental_scanner(const basic_incremental_scanner&) = delete;
+        basic_incremental_scanner& operator=(const basic_incremental_scanner&) = delete;
+
+        //Append a chunk of input.
+        void feed(string_view_type chunk)
+        {
+            append(chunk);
+            wake();
+        }
+
+        //Append a chunk of input and call f() after each complete record is stored to args.
+        template <typename F, typename... Args>
+        scan_status feed(string_view_type chunk, F&& f, Args&... args)
+        {
+            append(chunk);
+            scan_status status;
+            while ((status = next(args...)) == scan_status::complete)
+                f();
+            return status;
+        }
+
+        //Mark the end of input, so that the last field may end with it.
+        void finish()
+        {
+            ended = true;
+            wake();
+        }
+
+        //Try to scan the next record into args. The arguments should be the same until the record completes.
+        //After finish(), need_more means no record is left.
+        template <typename... Args>
+        scan_status next(Args&... args)
+        {
+            if (last_status == scan_status::error)
+                return last_status;
+            if (ended && only_spaces())
+                return last_status = scan_status::need_more;
+            last_status = pattern.resume(string_view_type(buffer), ended, progress, last_result, args...);
+            last_result.position -= start;
+            if (last_status == scan_status::complete)
+            {
+                start = progress.position;
+                progress = { 0, start };
+            }
+            return last_status;
+        }
+
+#ifdef __cpp_impl_coroutine
+        template <typename... Args>
+        class awaiter
+        {
+        private:
+            basic_incremental_scanner& scanner;
+            std::tuple<Args&...> args;
+            scan_status status;
+
+            bool try_next()
+            {
+                status = std::apply([this](Args&... args) { return scanner.next(args...); }, args);
+                return status != scan_status::need_more;
+            }
+
+        public:
+            awaiter(basic_incremental_scanner& scanner, Args&... args) : scanner(scanner), args(args...), status(scan_status::need_more) {}
+
+            bool await_ready() { return try_next() || scanner.ended; }
+            void await_suspend(std::coroutine_handle<> handle)
+            {
+                scanner.waiting = handle;
+                scanner.retry = [this]() { return try_next(); };
+            }
+            scan_status await_resume() const noexcept { return status; }
+        };
+
+        //co_await the next record. The coroutine is resumed by feed() or finish().
+        template <typename... Args>
+        awaiter<Args...> async_next(Args&... args)
+        {
+            return awaiter<Args...>(*this, args...);
+        }
+#endif // __cpp_impl_coroutine
+
+        //Where the last call stopped, relative to the start of the record.
+        const scan_result& result() const noexcept { return last_result; }
+        //The input which isn't consumed by complete records.
+        string_view_type pending() const noexcept { return string_view_type(buffer).substr(start); }
+
+        //Drop the input and the state, including an error.
+        void clear()
+        {
+            buffer.clear();
+            start = 0;
+            progress = { 0, 0 };
+            last_result = { scan_result::npos, 0, false };
+            last_status = scan_status::need_more;
+            ended = false;
+#ifdef __cpp_impl_coroutine
+            waiting = nullptr;
+            retry = nullptr;
+#endif // __cpp_impl_coroutine
+        }
+    };
+
+    using incremental_scanner = basic_incremental_scanner<char>;
+    using wincremental_scanner = basic_incremental_scanner<wchar_t>;
+} // namespace sf
+
+#endif // !SF_INCREMENTAL_SCANNER_HPP
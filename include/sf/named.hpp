@@ -0,0 +1,272 @@
+/**StreamFormat named.hpp
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2018-2020 Berrysoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+#ifndef SF_NAMED_HPP
+#define SF_NAMED_HPP
+
+#include <sf/utility.hpp>
+
+#include <array>
+#include <initializer_list>
+#include <sf/format.hpp>
+#include <sf/sformat.hpp>
+
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+    #define SF_HAS_STATIC_NAMES
+#endif // Class types as non-type template parameters
+
+namespace sf
+{
+    namespace internal
+    {
+        template <typename Char, typename Traits>
+        struct bind_names_result
+        {
+            std::size_t length;
+            bool missing;
+        };
+
+        //Replace {name} with the index of the name. Writes to out if it is not null, and returns the length.
+        template <typename Char, typename Traits>
+        constexpr bind_names_result<Char, Traits> bind_names(std::basic_string_view<Char, Traits> fmt, const std::basic_string_view<Char, Traits>* names, std::size_t count, Char* out) noexcept
+        {
+            bind_names_result<Char, Traits> result{ 0, false };
+            const std::size_t length = fmt.length();
+            auto put = [&](Char c) {
+                if (out)
+                    out[result.length] = c;
+                result.length++;
+            };
+            for (std::size_t i = 0; i < length; i++)
+            {
+                put(fmt[i]);
+                if (!Traits::eq(fmt[i], Char{ '{' }))
+                    continue;
+                if (i + 1 < length && Traits::eq(fmt[i + 1], Char{ '{' }))
+                {
+                    put(fmt[++i]);
+                    continue;
+                }
+                std::size_t end = i + 1;
+                while (end < length && !Traits::eq(fmt[end], Char{ ':' }) && !Traits::eq(fmt[end], Char{ '}' }))
+                    end++;
+                if (end == length || end == i + 1 || is_digit(fmt[i + 1]))
+                    continue;
+                std::basic_string_view<Char, Traits> name = fmt.substr(i + 1, end - i - 1);
+                std::size_t index = 0;
+                while (index < count && names[index] != name)
+                    index++;
+                if (index == count)
+                {
+                    result.missing = true;
+                    continue;
+                }
+                Char digits[integer_buffer_size]{};
+                std::size_t prefix = 0;
+                Char* last = digits + integer_buffer_size;
+                for (Char* first = format_integer(last, index, std::ios_base::dec, prefix); first != last; ++first)
+                    put(*first);
+                i = end - 1;
+            }
+            return result;
+        }
+    } // namespace internal
+
+    //A format string whose {name} placeholders are bound to indices once.
+    template <typename Char, typename Traits = std::char_traits<Char>, typename Allocator = std::allocator<Char>>
+    class basic_named_format
+    {
+    public:
+        using string_type = std::basic_string<Char, Traits, Allocator>;
+        using string_view_type = std::basic_string_view<Char, Traits>;
+
+    private:
+        string_type fmt;
+
+    public:
+        //The index of a name is its position in names. Unknown names are left as they are.
+        basic_named_format(string_view_type fmt, std::initializer_list<string_view_type> names)
+        {
+            auto result = internal::bind_names(fmt, names.begin(), names.size(), static_cast<Char*>(nullptr));
+            this->fmt.resize(result.length);
+            internal::bind_names(fmt, names.begin(), names.size(), this->fmt.data());
+        }
+
+        const string_type& str() const noexcept { return fmt; }
+        operator string_view_type() const noexcept { return fmt; }
+    };
+
+    using named_format = basic_named_format<char>;
+    using wnamed_format = basic_named_format<wchar_t>;
+
+#ifdef SF_HAS_STATIC_NAMES
+    namespace internal
+    {
+        template <typename Char, std::size_t N>
+        struct string_literal
+        {
+            Char data[N]{};
+
+            constexpr string_literal(const Char (&str)[N]) noexcept
+            {
+                for (std::size_t i = 0; i < N; i++)
+                    data[i] = str[i];
+            }
+
+            constexpr std::basic_string_view<Char> view() const noexcept { return { data, N - 1 }; }
+        };
+
+        template <string_literal Name, typename T>
+        struct static_named_arg
+        {
+            T value;
+        };
+
+        template <string_literal Fmt>
+        struct static_format
+        {
+        };
+
+        template <typename Char, typename T>
+        struct static_arg_name
+        {
+            static constexpr std::basic_string_view<Char> value{};
+        };
+        template <typename Char, string_literal Name, typename T>
+        struct static_arg_name<Char, static_named_arg<Name, T>>
+        {
+            static constexpr std::basic_string_view<Char> value = [] {
+                if constexpr (std::is_same_v<std::remove_cv_t<std::remove_reference_t<decltype(Name.data[0])>>, Char>)
+                    return Name.view();
+                else
+                    return std::basic_string_view<Char>{};
+            }();
+        };
+
+        template <typename T, typename U>
+        struct unwrap_static
+        {
+            using type = T;
+        };
+        template <typename T, string_literal Name, typename V>
+        struct unwrap_static<T, static_named_arg<Name, V>>
+        {
+            using type = V;
+        };
+
+        template <typename T>
+        constexpr decltype(auto) unwrap_static_arg(T&& arg) noexcept
+        {
+            using type = std::remove_cv_t<std::remove_reference_t<T>>;
+            if constexpr (!std::is_same_v<typename unwrap_static<T, type>::type, T>)
+                return std::forward<typename unwrap_static<T, type>::type>(arg.value);
+            else
+                return std::forward<T>(arg);
+        }
+
+        //The format string with names replaced by indices, computed at compile time.
+        template <string_literal Fmt, typename... Args>
+        struct static_bound_format
+        {
+            using char_type = std::remove_cv_t<std::remove_reference_t<decltype(Fmt.data[0])>>;
+            using string_view_type = std::basic_string_view<char_type>;
+
+            static constexpr string_view_type names[sizeof...(Args) + 1] = { static_arg_name<char_type, std::remove_cv_t<std::remove_reference_t<Args>>>::value..., {} };
+            static constexpr auto result = bind_names(Fmt.view(), names, sizeof...(Args), static_cast<char_type*>(nullptr));
+            static_assert(!result.missing, "A name in the format string is not passed by sf::arg<name>.");
+            static constexpr auto data = [] {
+                std::array<char_type, result.length + 1> buffer{};
+                bind_names(Fmt.view(), names, sizeof...(Args), buffer.data());
+                return buffer;
+            }();
+
+            template <typename Traits>
+            static constexpr std::basic_string_view<char_type, Traits> view() noexcept
+            {
+                return { data.data(), result.length };
+            }
+        };
+    } // namespace internal
+
+    //Wrap an argument with a name checked at compile time.
+    template <internal::string_literal Name, typename T>
+    constexpr internal::static_named_arg<Name, T> arg(T&& value) noexcept(std::is_nothrow_constructible_v<T, T&&>)
+    {
+        return { std::forward<T>(value) };
+    }
+
+    //A format string whose {name} placeholders are resolved at compile time.
+    template <internal::string_literal Fmt>
+    inline constexpr internal::static_format<Fmt> named{};
+
+    //template IO
+    template <typename Char, typename Traits, internal::string_literal Fmt, typename... Args>
+    std::basic_istream<Char, Traits>& scan(std::basic_istream<Char, Traits>& stream, internal::static_format<Fmt>, Args&&... args)
+    {
+        return internal::format<internal::input, Char, Traits>(stream, internal::static_bound_format<Fmt, Args...>::template view<Traits>(), internal::unwrap_static_arg(std::forward<Args>(args))...);
+    }
+    template <typename Char, typename Traits, internal::string_literal Fmt, typename... Args>
+    std::basic_ostream<Char, Traits>& print(std::basic_ostream<Char, Traits>& stream, internal::static_format<Fmt>, Args&&... args)
+    {
+        return internal::format<internal::output, Char, Traits>(stream, internal::static_bound_format<Fmt, Args...>::template view<Traits>(), internal::unwrap_static_arg(std::forward<Args>(args))...);
+    }
+    template <typename Char, typename Traits, internal::string_literal Fmt, typename... Args>
+    std::basic_ostream<Char, Traits>& println(std::basic_ostream<Char, Traits>& stream, internal::static_format<Fmt> fmt, Args&&... args)
+    {
+        return print(stream, fmt, std::forward<Args>(args)...) << std::endl;
+    }
+    template <internal::string_literal Fmt, typename... Args>
+    auto sscan(const std::basic_string<typename internal::static_bound_format<Fmt, Args...>::char_type>& str, internal::static_format<Fmt>, Args&&... args)
+    {
+        using char_type = typename internal::static_bound_format<Fmt, Args...>::char_type;
+        return sscan<char_type>(str, internal::static_bound_format<Fmt, Args...>::template view<std::char_traits<char_type>>(), internal::unwrap_static_arg(std::forward<Args>(args))...);
+    }
+    template <internal::string_literal Fmt, typename... Args>
+    auto sprint(internal::static_format<Fmt>, Args&&... args)
+    {
+        using char_type = typename internal::static_bound_format<Fmt, Args...>::char_type;
+        return sprint<char_type>(internal::static_bound_format<Fmt, Args...>::template view<std::char_traits<char_type>>(), internal::unwrap_static_arg(std::forward<Args>(args))...);
+    }
+
+    //char IO
+    template <internal::string_literal Fmt, typename... Args>
+    std::istream& scan(internal::static_format<Fmt> fmt, Args&&... args)
+    {
+        return scan(std::cin, fmt, std::forward<Args>(args)...);
+    }
+    template <internal::string_literal Fmt, typename... Args>
+    std::ostream& print(internal::static_format<Fmt> fmt, Args&&... args)
+    {
+        return print(std::cout, fmt, std::forward<Args>(args)...);
+    }
+    template <internal::string_literal Fmt, typename... Args>
+    std::ostream& println(internal::static_format<Fmt> fmt, Args&&... args)
+    {
+        return println(std::cout, fmt, std::forward<Args>(args)...);
+    }
+#endif // SF_HAS_STATIC_NAMES
+} // namespace sf
+
+#endif // !SF_NAMED_HPP
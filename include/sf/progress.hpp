@@ -0,0 +1,271 @@
+/**StreamFormat progress.hpp
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2018-2020 Berrysoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+#ifndef SF_PROGRESS_HPP
+#define SF_PROGRESS_HPP
+
+#include <sf/utility.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <sf/ansi.hpp>
+#include <sf/format.hpp>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sf
+{
+    //Status lines at the bottom of a terminal, redrawn by a renderer thread.
+    //Lines written to the stream meanwhile scroll above them.
+    class progress
+    {
+    public:
+        //A counter shown as a status line. Workers only add to it.
+        class counter
+        {
+        private:
+            std::atomic<std::uint64_t> value;
+            std::string label;
+            std::uint64_t total;
+
+            friend class progress;
+
+        public:
+            counter(std::string&& label, std::uint64_t total) : value(0), label(std::move(label)), total(total) {}
+
+            void add(std::uint64_t n = 1) noexcept { value.fetch_add(n, std::memory_order_relaxed); }
+            std::uint64_t get() const noexcept { return value.load(std::memory_order_relaxed); }
+        };
+
+    private:
+        //Collects the characters written to the stream in a line of the writing thread, and moves
+        //the complete lines to the pending text, so lines of different threads never mix. There is
+        //no put area, because one shared by the threads would be written without the mutex.
+        class interceptor : public std::streambuf
+        {
+        private:
+            struct line_entry
+            {
+                std::uint64_t id;
+                std::string text;
+            };
+
+            progress& owner;
+            std::uint64_t id;
+
+            //The line this thread is writing. Widgets are told apart by id, as an address may be reused.
+            std::string& line()
+            {
+                static thread_local std::vector<line_entry> lines;
+                for (line_entry& e : lines)
+                {
+                    if (e.id == id)
+                        return e.text;
+                }
+                for (std::size_t i = lines.size(); i > 0; i--)
+                {
+                    if (lines[i - 1].text.empty())
+                        lines.erase(lines.begin() + static_cast<std::ptrdiff_t>(i - 1));
+                }
+                return lines.emplace_back(line_entry{ id, {} }).text;
+            }
+
+            //Move the complete lines of the text to the pending text.
+            void hand_over(std::string& text)
+            {
+                std::size_t end = text.rfind('\n');
+                if (end == std::string::npos)
+                    return;
+                std::lock_guard<std::mutex> lock(owner.mutex);
+                owner.pending.append(text, 0, end + 1);
+                text.erase(0, end + 1);
+            }
+
+        protected:
+            int_type overflow(int_type c) override
+            {
+                if (!traits_type::eq_int_type(c, traits_type::eof()))
+                {
+                    std::string& text = line();
+                    text.push_back(traits_type::to_char_type(c));
+                    if (traits_type::to_char_type(c) == '\n')
+                        hand_over(text);
+                }
+                return traits_type::not_eof(c);
+            }
+            std::streamsize xsputn(const char* s, std::streamsize n) override
+            {
+                std::string& text = line();
+                text.append(s, static_cast<std::size_t>(n));
+                if (traits_type::find(s, static_cast<std::size_t>(n), '\n'))
+                    hand_over(text);
+                return n;
+            }
+            //The renderer draws the text at its next frame.
+            int sync() override
+            {
+                std::lock_guard<std::mutex> lock(owner.mutex);
+                commit();
+                owner.dirty = true;
+                return 0;
+            }
+
+        public:
+            interceptor(progress& owner) : owner(owner)
+            {
+                static std::atomic<std::uint64_t> next{ 0 };
+                id = next.fetch_add(1, std::memory_order_relaxed) + 1;
+            }
+
+            //Move the text this thread has written to the pending text. The mutex must be held.
+            void commit()
+            {
+                std::string& text = line();
+                owner.pending += text;
+                text.clear();
+            }
+        };
+
+        std::ostream& stream;
+        std::streambuf* dest;
+        interceptor buf;
+        std::chrono::milliseconds interval;
+        std::mutex mutex;
+        std::condition_variable wakeup;
+        std::deque<counter> counters;
+        std::vector<std::uint64_t> drawn_values;
+        std::string pending;
+        std::size_t drawn_lines;
+        bool dirty;
+        bool stopping;
+        std::thread renderer;
+
+        bool changed() const noexcept
+        {
+            if (dirty || pending.find('\n') != std::string::npos || drawn_lines != counters.size())
+                return true;
+            for (std::size_t i = 0; i < counters.size(); i++)
+            {
+                if (drawn_values[i] != counters[i].get())
+                    return true;
+            }
+            return false;
+        }
+
+        //Erase the status lines, write the complete lines written meanwhile, and draw the status lines again.
+        void draw()
+        {
+            std::ostringstream frame;
+            if (drawn_lines > 0)
+                frame << make_cursor_pre_line<char>(drawn_lines) << make_erase_screen<char>(erase_to_end);
+            std::size_t end = pending.rfind('\n');
+            if (end != std::string::npos)
+            {
+                frame.write(pending.data(), static_cast<std::streamsize>(end + 1));
+                pending.erase(0, end + 1);
+            }
+            drawn_values.resize(counters.size());
+            for (std::size_t i = 0; i < counters.size(); i++)
+            {
+                const counter& c = counters[i];
+                std::uint64_t value = c.get();
+                drawn_values[i] = value;
+                if (c.total > 0)
+                {
+                    const std::size_t width = 30;
+                    std::size_t filled = static_cast<std::size_t>(std::min(value, c.total) * width / c.total);
+                    print(frame, "{} [{}{}] {}/{} {:f1}%\n", c.label, std::string(filled, '#'), std::string(width - filled, '-'), value, c.total, value * 100.0 / c.total);
+                }
+                else
+                {
+                    print(frame, "{} {}\n", c.label, value);
+                }
+            }
+            drawn_lines = counters.size();
+            dirty = false;
+            std::string s = frame.str();
+            dest->sputn(s.data(), static_cast<std::streamsize>(s.length()));
+            dest->pubsync();
+        }
+
+        void run()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (!stopping)
+            {
+                wakeup.wait_for(lock, interval);
+                if (changed())
+                    draw();
+            }
+        }
+
+    public:
+        //Redraw at most once per interval. The stream shouldn't be used by others until stop().
+        explicit progress(std::ostream& stream = std::cout, std::chrono::milliseconds interval = std::chrono::milliseconds(100))
+            : stream(stream), dest(stream.rdbuf()), buf(*this), interval(interval), drawn_lines(0), dirty(false), stopping(false)
+        {
+            stream.flush();
+            stream.rdbuf(&buf);
+            renderer = std::thread(&progress::run, this);
+        }
+        progress(const progress&) = delete;
+        progress& operator=(const progress&) = delete;
+        ~progress() { stop(); }
+
+        //Add a status line. A total of 0 shows the count only.
+        counter& add(std::string label, std::uint64_t total = 0)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return counters.emplace_back(std::move(label), total);
+        }
+
+        //Draw the last frame, stop the renderer and give the stream back.
+        void stop()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (stopping)
+                    return;
+                stopping = true;
+            }
+            wakeup.notify_one();
+            renderer.join();
+            std::lock_guard<std::mutex> lock(mutex);
+            buf.commit();
+            if (!pending.empty() && pending.back() != '\n')
+                pending.push_back('\n');
+            draw();
+            stream.rdbuf(dest);
+        }
+    };
+} // namespace sf
+
+#endif // !SF_PROGRESS_HPP
@@ -0,0 +1,376 @@
+/**StreamFormat scan_pattern.hpp
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2018-2020 Berrysoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+#ifndef SF_SCAN_PATTERN_HPP
+#define SF_SCAN_PATTERN_HPP
+
+#include <sf/utility.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <sf/format.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sf
+{
+    //The result of matching a scan_pattern.
+    struct scan_result
+    {
+        static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+        //The index of the argument which failed, or npos if a literal mismatched.
+        std::size_t field;
+        //The offset in the line where the matching stopped.
+        std::size_t position;
+        bool ok;
+
+        constexpr explicit operator bool() const noexcept { return ok; }
+    };
+
+    enum class scan_status
+    {
+        need_more,
+        complete,
+        error
+    };
+
+    //Where a resumable match stopped: the index of the op and the offset in the input.
+    struct scan_progress
+    {
+        std::size_t op;
+        std::size_t position;
+    };
+
+    namespace internal
+    {
+        enum class scan_op_kind : unsigned char
+        {
+            literal,
+            skip_space,
+            field
+        };
+
+        template <typename Char>
+        struct scan_op
+        {
+            scan_op_kind kind;
+            //Literal: the range in the text. Field: the argument index.
+            std::size_t offset;
+            std::size_t length;
+            //Field: the first character of the following literal, where a string stops.
+            Char stop;
+            bool has_stop;
+            bool boolalpha;
+            int base;
+            //Field: the range of the flag text in the text, for a scanner.
+            std::size_t spec_offset = 0;
+            std::size_t spec_length = 0;
+        };
+
+        //Extract a field of type T, skipping leading spaces as operator>> does.
+        template <typename Char, typename Traits, typename T>
+        const Char* scan_extract(const Char* first, const Char* last, const scan_op<Char>& op, const Char* text, void* ptr)
+        {
+            T& value = *static_cast<T*>(ptr);
+            while (first != last && is_space(*first))
+                ++first;
+            if constexpr (std::is_same_v<T, bool>)
+            {
+                if (op.boolalpha)
+                {
+                    constexpr Char t[] = { Char{ 't' }, Char{ 'r' }, Char{ 'u' }, Char{ 'e' } };
+                    constexpr Char f[] = { Char{ 'f' }, Char{ 'a' }, Char{ 'l' }, Char{ 's' }, Char{ 'e' } };
+                    if (last - first >= 4 && Traits::compare(first, t, 4) == 0)
+                    {
+                        value = true;
+                        return first + 4;
+                    }
+                    if (last - first >= 5 && Traits::compare(first, f, 5) == 0)
+                    {
+                        value = false;
+                        return first + 5;
+                    }
+                    return nullptr;
+                }
+                long n;
+                const Char* end = parse_number(first, last, n, op.base);
+                if (!end || (n != 0 && n != 1))
+                    return nullptr;
+                value = n != 0;
+                return end;
+            }
+            else if constexpr (is_char_type_v<T>)
+            {
+                if (first == last)
+                    return nullptr;
+                value = static_cast<T>(*first);
+                return first + 1;
+            }
+            else if constexpr (has_scanner_v<T, Char>)
+            {
+                scanner<T, Char> s;
+                if constexpr (has_parse<scanner<T, Char>, Char>::value)
+                    s.parse(std::basic_string_view<Char>(text + op.spec_offset, op.spec_length));
+                return s.scan(first, last, value) ? first : nullptr;
+            }
+            else if constexpr (std::is_arithmetic_v<T>)
+            {
+                return parse_number(first, last, value, op.base);
+            }
+            else
+            {
+                const Char* end = first;
+                while (end != last && !is_space(*end) && !(op.has_stop && Traits::eq(*end, op.stop)))
+                    ++end;
+                if (end == first)
+                    return nullptr;
+                if constexpr (std::is_same_v<T, std::basic_string_view<Char, Traits>>)
+                {
+                    value = std::basic_string_view<Char, Traits>(first, static_cast<std::size_t>(end - first));
+                }
+                else if constexpr (is_basic_string<T>::value)
+                {
+                    value.assign(first, end);
+                }
+                else
+                {
+                    std::basic_istringstream<Char, Traits> iss(std::basic_string<Char, Traits>(first, end));
+                    if (!(iss >> value))
+                        return nullptr;
+                    auto pos = iss.tellg();
+                    return pos == decltype(pos)(-1) ? end : first + std::streamoff(pos);
+                }
+                return end;
+            }
+        }
+    } // namespace internal
+
+    //A format string compiled once to a matcher program, to scan many lines without streams.
+    template <typename Char, typename Traits = std::char_traits<Char>>
+    class scan_pattern
+    {
+    public:
+        using string_type = std::basic_string<Char, Traits>;
+        using string_view_type = std::basic_string_view<Char, Traits>;
+        using op_type = internal::scan_op<Char>;
+
+    private:
+        string_type text;
+        std::vector<op_type> program;
+
+        void push_literal(Char c)
+        {
+            if (program.empty() || program.back().kind != internal::scan_op_kind::literal)
+                program.push_back({ internal::scan_op_kind::literal, text.length(), 0, Char{}, false, false, 10 });
+            text.push_back(c);
+            program.back().length++;
+        }
+
+        void push_field(std::size_t index, string_view_type flags)
+        {
+            op_type op{ internal::scan_op_kind::field, index, 0, Char{}, false, false, 10, text.length(), flags.length() };
+            text.append(flags.data(), flags.length());
+            for (Char c : flags)
+            {
+                if (Traits::eq(c, Char{ 'd' }))
+                    op.base = 10;
+                else if (Traits::eq(c, Char{ 'o' }))
+                    op.base = 8;
+                else if (Traits::eq(c, Char{ 'x' }))
+                    op.base = 16;
+                else if (Traits::eq(c, Char{ 'b' }))
+                    op.boolalpha = true;
+            }
+            program.push_back(op);
+        }
+
+    public:
+        //Compile a format string with the same syntax as scan. Throws std::invalid_argument for a named field.
+        explicit scan_pattern(string_view_type fmt)
+        {
+            const std::size_t length = fmt.length();
+            std::size_t arg_index = 0;
+            for (std::size_t i = 0; i < length; i++)
+            {
+                Char c = fmt[i];
+                if (Traits::eq(c, Char{ '{' }))
+                {
+                    if (i + 1 < length && Traits::eq(fmt[i + 1], Char{ '{' }))
+                    {
+                        push_literal(c);
+                        i++;
+                        continue;
+                    }
+                    std::size_t end = fmt.find(Char{ '}' }, i + 1);
+                    if (end == string_view_type::npos)
+                    {
+                        for (; i < length; i++)
+                            push_literal(fmt[i]);
+                        break;
+                    }
+                    string_view_type spec = fmt.substr(i + 1, end - i - 1);
+                    std::size_t colon = spec.find(Char{ ':' });
+                    string_view_type index = spec.substr(0, colon);
+                    if (!index.empty())
+                    {
+                        //A failing name would report npos, which callers take for a literal.
+                        if (!internal::is_digit(index[0]))
+                            throw std::invalid_argument("scan_pattern doesn't support named fields");
+                        arg_index = internal::stou<std::size_t, Char, Traits>(index);
+                    }
+                    push_field(arg_index, colon == string_view_type::npos ? string_view_type{} : spec.substr(colon + 1));
+                    arg_index++;
+                    i = end;
+                }
+                else if (Traits::eq(c, Char{ '}' }) && i + 1 < length && Traits::eq(fmt[i + 1], Char{ '}' }))
+                {
+                    push_literal(c);
+                    i++;
+                }
+                else if (Traits::eq(c, Char{ ' ' }))
+                {
+                    if (program.empty() || program.back().kind != internal::scan_op_kind::skip_space)
+                        program.push_back({ internal::scan_op_kind::skip_space, 0, 0, Char{}, false, false, 10 });
+                }
+                else
+                {
+                    push_literal(c);
+                }
+            }
+            for (std::size_t i = 0; i + 1 < program.size(); i++)
+            {
+                if (program[i].kind == internal::scan_op_kind::field && program[i + 1].kind == internal::scan_op_kind::literal)
+                {
+                    program[i].stop = text[program[i + 1].offset];
+                    program[i].has_stop = true;
+                }
+            }
+        }
+
+        const std::vector<op_type>& ops() const noexcept { return program; }
+
+        //Match a line and store the fields to args.
+        //A string field stops at a space or at the first character of the following literal.
+        template <typename... Args>
+        scan_result match(string_view_type line, Args&... args) const
+        {
+            scan_progress progress{ 0, 0 };
+            scan_result result;
+            resume(line, true, progress, result, args...);
+            return result;
+        }
+
+        //Continue a match from progress. Unless the input is the last, a field, literal or spaces which
+        //reaches the end of the input returns need_more, and the next call retries it with more input.
+        template <typename... Args>
+        scan_status resume(string_view_type input, bool last, scan_progress& progress, scan_result& result, Args&... args) const
+        {
+            using extractor_type = const Char* (*)(const Char*, const Char*, const op_type&, const Char*, void*);
+            void* const ptrs[] = { static_cast<void*>(std::addressof(args))..., nullptr };
+            const extractor_type extractors[] = { &internal::scan_extract<Char, Traits, Args>..., nullptr };
+            const bool delimited[] = { !internal::is_char_type_v<Args>..., false };
+            const Char* const begin = input.data();
+            const Char* const end = begin + input.length();
+            const Char* it = begin + progress.position;
+            for (; progress.op < program.size(); progress.op++)
+            {
+                const op_type& op = program[progress.op];
+                progress.position = static_cast<std::size_t>(it - begin);
+                switch (op.kind)
+                {
+                case internal::scan_op_kind::literal:
+                {
+                    std::size_t n = std::min(static_cast<std::size_t>(end - it), op.length);
+                    if (Traits::compare(it, text.data() + op.offset, n) != 0 || (n < op.length && last))
+                    {
+                        result = { scan_result::npos, progress.position, false };
+                        return scan_status::error;
+                    }
+                    if (n < op.length)
+                    {
+                        result = { scan_result::npos, progress.position, false };
+                        return scan_status::need_more;
+                    }
+                    it += op.length;
+                    break;
+                }
+                case internal::scan_op_kind::skip_space:
+                    while (it != end && internal::is_space(*it))
+                        ++it;
+                    //More spaces may follow, so skip them again with more input.
+                    if (it == end && !last)
+                    {
+                        result = { scan_result::npos, progress.position, false };
+                        return scan_status::need_more;
+                    }
+                    break;
+                case internal::scan_op_kind::field:
+                {
+                    if (op.offset >= sizeof...(Args))
+                    {
+                        result = { op.offset, progress.position, false };
+                        return scan_status::error;
+                    }
+                    const Char* next = extractors[op.offset](it, end, op, text.data(), ptrs[op.offset]);
+                    //A token which runs to the end may go on in the next input, if the parser stopped at
+                    //the end or before characters of a number, like "1e" of "1e5", "0x" or the sign of "-12".
+                    if (!last && (delimited[op.offset] || !next) && reaches_end(it, end, op) && (!next || std::all_of(next, end, internal::is_number_char<Char>)))
+                    {
+                        result = { op.offset, progress.position, false };
+                        return scan_status::need_more;
+                    }
+                    if (!next)
+                    {
+                        result = { op.offset, progress.position, false };
+                        return scan_status::error;
+                    }
+                    it = next;
+                    break;
+                }
+                }
+            }
+            progress.position = static_cast<std::size_t>(it - begin);
+            result = { scan_result::npos, progress.position, true };
+            return scan_status::complete;
+        }
+
+    private:
+        //Whether the token of a field, after spaces, runs to the end of the input.
+        static bool reaches_end(const Char* it, const Char* end, const op_type& op) noexcept
+        {
+            while (it != end && internal::is_space(*it))
+                ++it;
+            while (it != end && !internal::is_space(*it) && !(op.has_stop && Traits::eq(*it, op.stop)))
+                ++it;
+            return it == end;
+        }
+    };
+} // namespace sf
+
+#endif // !SF_SCAN_PATTERN_HPP
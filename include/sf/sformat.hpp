@@ -29,25 +29,651 @@
 #include <sf/utility.hpp>
 
 #include <sf/format.hpp>
+#include <locale>
+#include <memory>
+#include <sf/unicode.hpp>
 #include <sstream>
+#include <vector>
 
 namespace sf
 {
     namespace internal
     {
+        //A put area over a string which keeps its capacity between uses.
+        template <typename Char, typename Traits>
+        class string_sink_buf : public std::basic_streambuf<Char, Traits>
+        {
+        private:
+            std::basic_string<Char, Traits> buffer;
+
+        public:
+            string_sink_buf() : buffer(64, Char{}) { reset(); }
+
+            void reset() { this->setp(buffer.data(), buffer.data() + buffer.size()); }
+
+            std::basic_string_view<Char, Traits> view() const noexcept
+            {
+                return std::basic_string_view<Char, Traits>(this->pbase(), static_cast<std::size_t>(this->pptr() - this->pbase()));
+            }
+
+            std::size_t capacity() const noexcept { return buffer.size(); }
+
+        protected:
+            typename Traits::int_type overflow(typename Traits::int_type ch) override
+            {
+                if (Traits::eq_int_type(ch, Traits::eof()))
+                    return Traits::not_eof(ch);
+                const std::size_t count = static_cast<std::size_t>(this->pptr() - this->pbase());
+                buffer.resize(buffer.size() * 2);
+                this->setp(buffer.data(), buffer.data() + buffer.size());
+                this->pbump(static_cast<int>(count));
+                *this->pptr() = Traits::to_char_type(ch);
+                this->pbump(1);
+                return ch;
+            }
+
+            std::streamsize xsputn(const Char* s, std::streamsize n) override
+            {
+                const std::size_t count = static_cast<std::size_t>(this->pptr() - this->pbase());
+                const std::size_t need = count + static_cast<std::size_t>(n);
+                if (need > buffer.size())
+                {
+                    buffer.resize((std::max)(need, buffer.size() * 2));
+                    this->setp(buffer.data(), buffer.data() + buffer.size());
+                    this->pbump(static_cast<int>(count));
+                }
+                Traits::copy(this->pptr(), s, static_cast<std::size_t>(n));
+                this->pbump(static_cast<int>(n));
+                return n;
+            }
+        };
+
+        //A get area over a borrowed string, so that scanning copies nothing and parses numbers in place.
+        template <typename Char, typename Traits>
+        class string_view_buf : public block_streambuf<Char, Traits>
+        {
+        public:
+            void reset(std::basic_string_view<Char, Traits> str)
+            {
+                Char* first = const_cast<Char*>(str.data());
+                this->setg(first, first, first + str.length());
+            }
+
+            bool refill() override { return false; }
+
+        protected:
+            typename Traits::pos_type seekoff(typename Traits::off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override
+            {
+                if (!(which & std::ios_base::in))
+                    return typename Traits::pos_type(-1);
+                typename Traits::off_type base = 0;
+                if (dir == std::ios_base::cur)
+                    base = this->gptr() - this->eback();
+                else if (dir == std::ios_base::end)
+                    base = this->egptr() - this->eback();
+                const typename Traits::off_type pos = base + off;
+                if (pos < 0 || pos > this->egptr() - this->eback())
+                    return typename Traits::pos_type(-1);
+                this->setg(this->eback(), this->eback() + pos, this->egptr());
+                return typename Traits::pos_type(pos);
+            }
+
+            typename Traits::pos_type seekpos(typename Traits::pos_type pos, std::ios_base::openmode which) override
+            {
+                return seekoff(typename Traits::off_type(pos), std::ios_base::beg, which);
+            }
+        };
+
+        template <io_state IOState, typename Char, typename Traits>
+        struct pooled_stream;
+
+        template <typename Char, typename Traits>
+        struct pooled_stream<output, Char, Traits>
+        {
+            string_sink_buf<Char, Traits> buf;
+            std::basic_ostream<Char, Traits> stream{ &buf };
+        };
+
+        template <typename Char, typename Traits>
+        struct pooled_stream<input, Char, Traits>
+        {
+            string_view_buf<Char, Traits> buf;
+            std::basic_istream<Char, Traits> stream{ &buf };
+
+            pooled_stream() { publish(); }
+
+            void publish() { stream.pword(block_streambuf<Char, Traits>::index) = stream.getloc() == std::locale::classic() ? &buf : nullptr; }
+        };
+
+        template <typename T>
+        struct is_basic_string_view : std::false_type
+        {
+        };
+        template <typename Char, typename Traits>
+        struct is_basic_string_view<std::basic_string_view<Char, Traits>> : std::true_type
+        {
+        };
+
+        //Whether formatting T may call an operator of the user, which can leave iword or pword
+        //slots and callbacks of its own on the stream.
+        template <typename T>
+        constexpr bool is_foreign_arg() noexcept
+        {
+            using type = std::remove_cv_t<std::remove_reference_t<unwrap_named_t<T>>>;
+            if constexpr (std::is_arithmetic_v<type> || std::is_pointer_v<type> || std::is_array_v<type> || is_basic_string<type>::value || is_basic_string_view<type>::value)
+                return false;
+            else if constexpr (!std::is_void_v<list_element_t<type>>)
+                return is_foreign_arg<list_element_t<type>>();
+            else
+                return true;
+        }
+
+        //A thread-local pool of string streams. A call nested in formatting, e.g. sprint in an
+        //operator<<, takes another stream. A stream is returned only after a successful call,
+        //and is reset to the state of a new one before it is handed out again. After a user operator,
+        //the slots and callbacks it may have added are dropped as well.
+        template <io_state IOState, typename Char, typename Traits>
+        class stream_pool
+        {
+        public:
+            using stream_type = pooled_stream<IOState, Char, Traits>;
+
+            static constexpr std::size_t max_streams = 4;
+            static constexpr std::size_t max_capacity = 65536;
+
+        private:
+            std::vector<std::unique_ptr<stream_type>> free;
+
+            //The format state of a new stream, without slots or callbacks.
+            static const std::basic_ios<Char, Traits>& pristine()
+            {
+                static thread_local const std::basic_ostream<Char, Traits> stream(nullptr);
+                return stream;
+            }
+
+            //Replace every slot and callback, which a stream can't list to reset one by one.
+            //It is slower than reset, so only streams given to user operators pay for it.
+            static void scrub(stream_type& s)
+            {
+                auto& stream = s.stream;
+                stream.copyfmt(pristine());
+                if (s.buf.getloc() != stream.getloc())
+                    s.buf.pubimbue(stream.getloc());
+                if constexpr (IOState == input)
+                    s.publish();
+            }
+
+            static void reset(stream_type& s, const std::locale& loc)
+            {
+                auto& stream = s.stream;
+                if (stream.rdbuf() != &s.buf)
+                    stream.rdbuf(&s.buf);
+                stream.exceptions(std::ios_base::goodbit);
+                stream.clear();
+                stream.flags(std::ios_base::skipws | std::ios_base::dec);
+                stream.precision(6);
+                stream.width(0);
+                stream.fill(stream.widen(' '));
+                stream.tie(nullptr);
+                stream.iword(format_ext::index) = 0;
+                stream.pword(format_spec::index) = nullptr;
+                if (stream.getloc() != loc)
+                {
+                    stream.imbue(loc);
+                    if constexpr (IOState == input)
+                        s.publish();
+                }
+            }
+
+        public:
+            static stream_pool& instance()
+            {
+                static thread_local stream_pool pool;
+                return pool;
+            }
+
+            std::unique_ptr<stream_type> acquire()
+            {
+                if (free.empty())
+                    return std::make_unique<stream_type>();
+                std::unique_ptr<stream_type> s = std::move(free.back());
+                free.pop_back();
+                reset(*s, std::locale());
+                return s;
+            }
+
+            void release(std::unique_ptr<stream_type> s, bool foreign)
+            {
+                if constexpr (IOState == output)
+                {
+                    if (s->buf.capacity() > max_capacity)
+                        return;
+                    s->buf.reset();
+                }
+                if (free.size() < max_streams)
+                {
+                    if (foreign)
+                        scrub(*s);
+                    free.push_back(std::move(s));
+                }
+            }
+        };
+
+        template <typename Char, typename Traits, typename Allocator, typename... Args>
+        typename Traits::pos_type sscan(const std::basic_string<Char, Traits, Allocator>& str, std::basic_string_view<Char, Traits> fmt, Args&&... args)
+        {
+            auto& pool = stream_pool<input, Char, Traits>::instance();
+            auto s = pool.acquire();
+            s->buf.reset(std::basic_string_view<Char, Traits>(str.data(), str.length()));
+            format<input>(s->stream, fmt, std::forward<Args>(args)...);
+            typename Traits::pos_type pos = s->stream.tellg();
+            pool.release(std::move(s), (is_foreign_arg<Args>() || ...));
+            return pos;
+        }
+        template <typename Char, typename Traits, typename Allocator, typename... Args>
+        std::basic_string<Char, Traits, Allocator> sprint(std::basic_string_view<Char, Traits> fmt, Args&&... args)
+        {
+            auto& pool = stream_pool<output, Char, Traits>::instance();
+            auto s = pool.acquire();
+            format<output>(s->stream, fmt, std::forward<Args>(args)...);
+            auto view = s->buf.view();
+            std::basic_string<Char, Traits, Allocator> result(view.data(), view.length());
+            pool.release(std::move(s), (is_foreign_arg<Args>() || ...));
+            return result;
+        }
+
+        //Unicode IO works on the code units directly, as char16_t and char32_t streams have no
+        //num_put or ctype facets. Literals and strings are copied, numbers are formatted and parsed
+        //in place, and the flags of a spec are read by applying them to a pooled char stream.
+        //Other types go through the char engine on UTF-8, one field at a time.
+
+        //Call f with the argument at index.
+        template <typename F, typename... Args>
+        void visit_arg(std::size_t index, F&& f, Args&... args)
+        {
+            std::size_t i = 0;
+            static_cast<void>(((i++ == index ? (f(unwrap_named_arg(args)), true) : false) || ...));
+        }
+
+        //Apply the flags of a spec to a pooled char stream and call f with it. Returns false
+        //if the spec isn't ASCII.
+        template <io_state IOState, typename Char, typename Traits, typename F>
+        bool with_spec_flags(std::basic_string_view<Char, Traits> spec, F&& f)
+        {
+            using stream_type = stream_t<IOState, char, std::char_traits<char>>;
+            std::string narrow;
+            for (Char c : spec)
+            {
+                if (static_cast<std::uint32_t>(c) >= 0x80)
+                    return false;
+                narrow.push_back(static_cast<char>(c));
+            }
+            auto& pool = stream_pool<IOState, char, std::char_traits<char>>::instance();
+            auto s = pool.acquire();
+            arg_t<stream_type> arg = [&f](stream_type& stream) -> stream_type& {
+                f(stream);
+                return stream;
+            };
+            format_arg_io<IOState, char, std::char_traits<char>>{ arg, narrow }(s->stream);
+            pool.release(std::move(s), false);
+            return true;
+        }
+
+        //The state of a char stream which a number is written with.
+        struct utf_number_format
+        {
+            std::ios_base::fmtflags flags = std::ios_base::dec;
+            std::streamsize width = 0;
+            std::streamsize precision = 6;
+            char fill = ' ';
+
+            utf_number_format() = default;
+            utf_number_format(const std::ostream& stream) : flags(stream.flags()), width(stream.width()), precision(stream.precision()), fill(stream.fill()) {}
+        };
+
+        //Append the text with the width, fill and adjustfield of the format, as put_padded does.
+        template <typename Char, typename Traits, typename Allocator>
+        void utf_put_padded(std::basic_string<Char, Traits, Allocator>& out, const Char* str, std::size_t len, std::size_t prefix, const utf_number_format& format)
+        {
+            const std::size_t width = format.width > 0 ? static_cast<std::size_t>(format.width) : 0;
+            const Char fill = static_cast<Char>(static_cast<unsigned char>(format.fill));
+            if (width <= len)
+            {
+                out.append(str, len);
+                return;
+            }
+            const std::ios_base::fmtflags adjust = format.flags & std::ios_base::adjustfield;
+            if (adjust == std::ios_base::left)
+            {
+                out.append(str, len);
+                out.append(width - len, fill);
+            }
+            else
+            {
+                const std::size_t head = adjust == std::ios_base::internal ? prefix : 0;
+                out.append(str, head);
+                out.append(width - len, fill);
+                out.append(str + head, len - head);
+            }
+        }
+
+        //Append a number as a char stream in the classic locale writes it. Returns false for
+        //hexfloat and showpoint, which are left to num_put.
+        template <typename Char, typename Traits, typename Allocator, typename T>
+        bool utf_put_number(std::basic_string<Char, Traits, Allocator>& out, T value, const utf_number_format& format)
+        {
+            if constexpr (std::is_same_v<T, bool>)
+            {
+                if (format.flags & std::ios_base::boolalpha)
+                {
+                    constexpr Char t[] = { Char{ 't' }, Char{ 'r' }, Char{ 'u' }, Char{ 'e' } };
+                    constexpr Char f[] = { Char{ 'f' }, Char{ 'a' }, Char{ 'l' }, Char{ 's' }, Char{ 'e' } };
+                    if (value)
+                        utf_put_padded(out, t, 4, 0, format);
+                    else
+                        utf_put_padded(out, f, 5, 0, format);
+                    return true;
+                }
+                return utf_put_number(out, static_cast<long>(value), format);
+            }
+            else if constexpr (is_fast_integer_v<T>)
+            {
+                Char buffer[integer_buffer_size];
+                std::size_t prefix;
+                Char* first = format_integer(buffer + integer_buffer_size, value, format.flags, prefix);
+                utf_put_padded(out, first, static_cast<std::size_t>(buffer + integer_buffer_size - first), prefix, format);
+                return true;
+            }
+            else
+            {
+#ifdef __cpp_lib_to_chars
+                if (!float_chars::supports(format.flags))
+                    return false;
+                //num_put writes "%.*g" unless fixed or scientific is set.
+                const float_chars text(value, format.flags, format.precision, false);
+                const char* first = text.data();
+                const std::size_t len = text.size();
+                Char wide_local[128];
+                std::vector<Char> wide_heap;
+                Char* wide = wide_local;
+                if (len > sizeof(wide_local) / sizeof(Char))
+                {
+                    wide_heap.resize(len);
+                    wide = wide_heap.data();
+                }
+                widen_ascii(first, len, wide);
+                utf_put_padded(out, wide, len, text.prefix(), format);
+                return true;
+#else
+                return false;
+#endif // __cpp_lib_to_chars
+            }
+        }
+
+        //A field in UTF-8 for the char engine.
+        template <typename Char, typename Traits>
+        std::string utf8_field(std::basic_string_view<Char, Traits> spec, bool has_spec)
+        {
+            std::string field(1, '{');
+            if (has_spec)
+            {
+                field.push_back(':');
+                utf8_encode_append(field, spec.data(), spec.length());
+            }
+            field.push_back('}');
+            return field;
+        }
+
+        template <typename Char, typename Traits, typename Allocator, typename T>
+        void utf_put_arg(std::basic_string<Char, Traits, Allocator>& out, std::basic_string_view<Char, Traits> spec, bool has_spec, const T& arg)
+        {
+            using char_type = string_char_t<T>;
+            if constexpr (is_fast_integer_v<T> || std::is_same_v<T, bool> || std::is_floating_point_v<T>)
+            {
+                bool done = false;
+                if (!has_spec)
+                    done = utf_put_number(out, arg, utf_number_format{});
+                else
+                    with_spec_flags<output>(spec, [&](std::ostream& stream) { done = utf_put_number(out, arg, utf_number_format(stream)); });
+                if (done)
+                    return;
+            }
+            else if constexpr (std::is_same_v<T, Char>)
+            {
+                if (!has_spec)
+                {
+                    out.push_back(arg);
+                    return;
+                }
+            }
+            else if constexpr (!std::is_void_v<char_type> && (std::is_same_v<char_type, char> || is_transcoded_char_v<char_type>))
+            {
+                if (!has_spec)
+                {
+                    const char_type* str;
+                    std::size_t len;
+                    if constexpr (std::is_pointer_v<std::decay_t<T>>)
+                    {
+                        str = arg;
+                        len = std::char_traits<char_type>::length(arg);
+                    }
+                    else
+                    {
+                        str = arg.data();
+                        len = arg.size();
+                    }
+                    if constexpr (std::is_same_v<char_type, Char>)
+                    {
+                        out.append(str, len);
+                    }
+                    else if constexpr (sizeof(char_type) == 1)
+                    {
+                        utf8_append(out, std::string_view(reinterpret_cast<const char*>(str), len));
+                    }
+                    else
+                    {
+                        const char_type* end = str + len;
+                        while (str != end)
+                        {
+                            Char units[4];
+                            out.append(units, static_cast<std::size_t>(utf_encode(utf_decode(str, end), units) - units));
+                        }
+                    }
+                    return;
+                }
+            }
+            utf8_append(out, sprint<char, std::char_traits<char>, std::allocator<char>>(std::string_view(utf8_field(spec, has_spec)), utf8_output_arg(arg)));
+        }
+
         template <typename Char, typename Traits, typename Allocator, typename... Args>
-        constexpr typename Traits::pos_type sscan(const std::basic_string<Char, Traits, Allocator>& str, std::basic_string_view<Char, Traits> fmt, Args&&... args)
+        std::basic_string<Char, Traits, Allocator> usprint(std::basic_string_view<Char, Traits> fmt, Args&&... args)
+        {
+            const std::basic_string_view<Char, Traits> names[] = { named_arg_name<Char, Traits>(args)..., {} };
+            std::basic_string<Char, Traits, Allocator> result;
+            result.reserve(fmt.length());
+            format_walk(
+                fmt, sizeof...(Args), names,
+                [&](std::basic_string_view<Char, Traits> text) { result.append(text.data(), text.length()); },
+                [&](std::size_t index, std::basic_string_view<Char, Traits> spec, bool has_spec) {
+                    visit_arg(index, [&](const auto& arg) { utf_put_arg(result, spec, has_spec, arg); }, args...);
+                });
+            return result;
+        }
+
+        //Where a scan is in the input, with the eofbit and failbit of a stream.
+        template <typename Char>
+        struct utf_scan_state
+        {
+            const Char* it;
+            const Char* end;
+            bool eof;
+            bool fail;
+
+            //A stream with eofbit fails the next read, as its sentry does.
+            bool ready() noexcept
+            {
+                fail = fail || eof;
+                return !fail;
+            }
+        };
+
+        //Match literal text as string_view_io does.
+        template <typename Char, typename Traits>
+        void utf_scan_literal(utf_scan_state<Char>& s, std::basic_string_view<Char, Traits> text)
         {
-            std::basic_istringstream<Char, Traits, Allocator> iss(str);
-            format<input>(iss, fmt, std::forward<Args>(args)...);
-            return iss.tellg();
+            if (s.fail)
+                return;
+            for (Char c : text)
+            {
+                if (Traits::eq(c, Char{ ' ' }))
+                {
+                    if (!s.ready())
+                        return;
+                    while (s.it != s.end && (Traits::eq(*s.it, Char{ ' ' }) || Traits::eq(*s.it, Char{ '\t' }) || Traits::eq(*s.it, Char{ '\v' }) || Traits::eq(*s.it, Char{ '\r' }) || Traits::eq(*s.it, Char{ '\n' })))
+                        ++s.it;
+                    s.eof = s.it == s.end;
+                }
+                else
+                {
+                    while (true)
+                    {
+                        if (!s.ready())
+                            return;
+                        if (s.it == s.end)
+                        {
+                            s.eof = s.fail = true;
+                            return;
+                        }
+                        if (Traits::eq(*s.it++, c))
+                            break;
+                    }
+                }
+            }
         }
+
+        //Skip spaces as the sentry of operator>> does. Returns false if nothing is left.
+        template <typename Char>
+        bool utf_scan_skip(utf_scan_state<Char>& s)
+        {
+            if (!s.ready())
+                return false;
+            while (s.it != s.end && is_space(*s.it))
+                ++s.it;
+            if (s.it == s.end)
+            {
+                s.eof = s.fail = true;
+                return false;
+            }
+            return true;
+        }
+
+        //Read a field as the char engine does with the input transcoded to UTF-8.
+        template <typename Char, typename Traits, typename T>
+        void utf_scan_fallback(utf_scan_state<Char>& s, std::basic_string_view<Char, Traits> spec, bool has_spec, T& arg)
+        {
+            if (s.fail)
+                return;
+            std::string text;
+            utf8_encode_append(text, s.it, static_cast<std::size_t>(s.end - s.it));
+            auto& pool = stream_pool<input, char, std::char_traits<char>>::instance();
+            auto p = pool.acquire();
+            p->buf.reset(text);
+            p->stream.clear(s.eof ? std::ios_base::eofbit : std::ios_base::goodbit);
+            format<input>(p->stream, std::string_view(utf8_field(spec, has_spec)), utf8_input_arg(arg));
+            const std::streamoff consumed = p->buf.pubseekoff(0, std::ios_base::cur, std::ios_base::in);
+            s.eof = p->stream.eof();
+            s.fail = p->stream.fail();
+            pool.release(std::move(p), is_foreign_arg<T>());
+            //Advance by the code units of the consumed UTF-8.
+            const char* first = text.data();
+            const char* const last = first + consumed;
+            while (first < last)
+            {
+                const char32_t cp = utf8_decode(first, last);
+                s.it += sizeof(Char) == 1 ? (cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4) : sizeof(Char) == 2 && cp >= 0x10000 ? 2 : 1;
+            }
+        }
+
+        template <typename Char, typename Traits, typename T>
+        void utf_scan_arg(utf_scan_state<Char>& s, std::basic_string_view<Char, Traits> spec, bool has_spec, T& arg)
+        {
+            if constexpr (is_in_place_v<T>)
+            {
+                int base = 10;
+                if (!has_spec || with_spec_flags<input>(spec, [&](std::istream& stream) { base = number_base(stream.flags()); }))
+                {
+                    const Char* next = nullptr;
+                    if (base && s.ready() && s.it != s.end)
+                    {
+                        const Char* first = s.it;
+                        while (first != s.end && is_space(*first))
+                            first++;
+                        next = first == s.end ? nullptr : parse_in_place(first, s.end, arg, base);
+                    }
+                    if (next)
+                    {
+                        s.it = next;
+                        s.eof = next == s.end;
+                        return;
+                    }
+                }
+            }
+            else if constexpr (std::is_same_v<T, Char>)
+            {
+                if (!has_spec)
+                {
+                    if (utf_scan_skip(s))
+                        arg = *s.it++;
+                    return;
+                }
+            }
+            else if constexpr (is_basic_string<T>::value)
+            {
+                using char_type = typename T::value_type;
+                if constexpr (std::is_same_v<char_type, char> || is_transcoded_char_v<char_type>)
+                {
+                    if (!has_spec)
+                    {
+                        if (utf_scan_skip(s))
+                        {
+                            const Char* first = s.it;
+                            while (s.it != s.end && !is_space(*s.it))
+                                ++s.it;
+                            s.eof = s.it == s.end;
+                            arg.clear();
+                            if constexpr (std::is_same_v<char_type, Char>)
+                            {
+                                arg.append(first, static_cast<std::size_t>(s.it - first));
+                            }
+                            else
+                            {
+                                std::string word;
+                                utf8_encode_append(word, first, static_cast<std::size_t>(s.it - first));
+                                utf8_append(arg, word);
+                            }
+                        }
+                        return;
+                    }
+                }
+            }
+            utf_scan_fallback(s, spec, has_spec, arg);
+        }
+
         template <typename Char, typename Traits, typename Allocator, typename... Args>
-        constexpr std::basic_string<Char, Traits, Allocator> sprint(std::basic_string_view<Char, Traits> fmt, Args&&... args)
+        typename Traits::pos_type usscan(const std::basic_string<Char, Traits, Allocator>& str, std::basic_string_view<Char, Traits> fmt, Args&&... args)
         {
-            std::basic_ostringstream<Char, Traits, Allocator> oss;
-            format<output>(oss, fmt, std::forward<Args>(args)...);
-            return oss.str();
+            const std::basic_string_view<Char, Traits> names[] = { named_arg_name<Char, Traits>(args)..., {} };
+            utf_scan_state<Char> s{ str.data(), str.data() + str.length(), false, false };
+            format_walk(
+                fmt, sizeof...(Args), names,
+                [&](std::basic_string_view<Char, Traits> text) { utf_scan_literal(s, text); },
+                [&](std::size_t index, std::basic_string_view<Char, Traits> spec, bool has_spec) {
+                    visit_arg(index, [&](auto& arg) { utf_scan_arg(s, spec, has_spec, arg); }, args...);
+                });
+            //tellg fails after eofbit, as the sentry sets failbit.
+            if (s.fail || s.eof)
+                return typename Traits::pos_type(-1);
+            return typename Traits::pos_type(static_cast<std::streamoff>(s.it - str.data()));
         }
     } // namespace internal
 
@@ -55,60 +681,92 @@ namespace sf
     template <typename Char, typename Traits = std::char_traits<Char>, typename Allocator = std::allocator<Char>, typename... Args, typename Str, typename = std::enable_if_t<std::is_convertible_v<Str, std::basic_string<Char, Traits, Allocator>>>, typename String, typename = std::enable_if_t<std::is_convertible_v<String, std::basic_string_view<Char, Traits>>>>
     constexpr typename Traits::pos_type sscan(Str&& str, String&& fmt, Args&&... args)
     {
-        return internal::sscan<Char, Traits, Allocator>(str, fmt, std::forward<Args>(args)...);
+        if constexpr (internal::is_utf_char_v<Char>)
+            return internal::usscan<Char, Traits, Allocator>(str, fmt, std::forward<Args>(args)...);
+        else
+            return internal::sscan<Char, Traits, Allocator>(str, fmt, std::forward<Args>(args)...);
     }
     template <typename Char, typename Traits = std::char_traits<Char>, typename Allocator = std::allocator<Char>, typename String, typename... Args, typename = std::enable_if_t<std::is_convertible_v<String, std::basic_string_view<Char, Traits>>>>
     constexpr std::basic_string<Char, Traits, Allocator> sprint(String&& fmt, Args&&... args)
     {
-        return internal::sprint<Char, Traits, Allocator>(fmt, std::forward<Args>(args)...);
+        if constexpr (internal::is_utf_char_v<Char>)
+            return internal::usprint<Char, Traits, Allocator>(fmt, std::forward<Args>(args)...);
+        else
+            return internal::sprint<Char, Traits, Allocator>(fmt, std::forward<Args>(args)...);
     }
 
     //char IO
     template <typename... Args>
     constexpr auto sscan(const std::string& str, std::string_view fmt, Args&&... args)
     {
-        return sscan<char>(str, fmt, std::forward<Args>(args)...);
+        return sscan<char, std::char_traits<char>, std::allocator<char>>(str, fmt, std::forward<Args>(args)...);
     }
     template <typename... Args>
     constexpr auto sprint(std::string_view fmt, Args&&... args)
     {
-        return sprint<char>(fmt, std::forward<Args>(args)...);
+        return sprint<char, std::char_traits<char>, std::allocator<char>>(fmt, std::forward<Args>(args)...);
     }
 
     //wchar_t IO
     template <typename... Args>
     constexpr auto wsscan(const std::wstring& str, std::wstring_view fmt, Args&&... args)
     {
-        return sscan<wchar_t>(str, fmt, std::forward<Args>(args)...);
+        return sscan<wchar_t, std::char_traits<wchar_t>, std::allocator<wchar_t>>(str, fmt, std::forward<Args>(args)...);
     }
     template <typename... Args>
     constexpr auto wsprint(std::wstring_view fmt, Args&&... args)
     {
-        return sprint<wchar_t>(fmt, std::forward<Args>(args)...);
+        return sprint<wchar_t, std::char_traits<wchar_t>, std::allocator<wchar_t>>(fmt, std::forward<Args>(args)...);
     }
 
+    //The unicode overloads call sf:: explicitly, so that named arguments don't bring the char engine
+    //in internal:: by argument-dependent lookup.
+#ifdef __cpp_char8_t
+    //char8_t IO
+    template <typename... Args>
+    constexpr auto u8sscan(const std::u8string& str, std::u8string_view fmt, Args&&... args)
+    {
+        return sf::sscan<char8_t, std::char_traits<char8_t>, std::allocator<char8_t>>(str, fmt, std::forward<Args>(args)...);
+    }
+    template <typename... Args>
+    constexpr auto u8sprint(std::u8string_view fmt, Args&&... args)
+    {
+        return sf::sprint<char8_t, std::char_traits<char8_t>, std::allocator<char8_t>>(fmt, std::forward<Args>(args)...);
+    }
+#endif // __cpp_char8_t
+
     //char16_t IO
     template <typename... Args>
     constexpr auto u16sscan(const std::u16string& str, std::u16string_view fmt, Args&&... args)
     {
-        return sscan<char16_t>(str, fmt, std::forward<Args>(args)...);
+        return sf::sscan<char16_t, std::char_traits<char16_t>, std::allocator<char16_t>>(str, fmt, std::forward<Args>(args)...);
     }
     template <typename... Args>
     constexpr auto u16sprint(std::u16string_view fmt, Args&&... args)
     {
-        return sprint<char16_t>(fmt, std::forward<Args>(args)...);
+        return sf::sprint<char16_t, std::char_traits<char16_t>, std::allocator<char16_t>>(fmt, std::forward<Args>(args)...);
     }
 
     //char32_t IO
     template <typename... Args>
-    constexpr auto u16sscan(const std::u32string& str, std::u32string_view fmt, Args&&... args)
+    constexpr auto u32sscan(const std::u32string& str, std::u32string_view fmt, Args&&... args)
+    {
+        return sf::sscan<char32_t, std::char_traits<char32_t>, std::allocator<char32_t>>(str, fmt, std::forward<Args>(args)...);
+    }
+    template <typename... Args>
+    constexpr auto u32sprint(std::u32string_view fmt, Args&&... args)
+    {
+        return sf::sprint<char32_t, std::char_traits<char32_t>, std::allocator<char32_t>>(fmt, std::forward<Args>(args)...);
+    }
+    template <typename... Args>
+    [[deprecated("Use u32sscan instead.")]] constexpr auto u16sscan(const std::u32string& str, std::u32string_view fmt, Args&&... args)
     {
-        return sscan<char32_t>(str, fmt, std::forward<Args>(args)...);
+        return u32sscan(str, fmt, std::forward<Args>(args)...);
     }
     template <typename... Args>
-    constexpr auto u16sprint(std::u32string_view fmt, Args&&... args)
+    [[deprecated("Use u32sprint instead.")]] constexpr auto u16sprint(std::u32string_view fmt, Args&&... args)
     {
-        return sprint<char32_t>(fmt, std::forward<Args>(args)...);
+        return u32sprint(fmt, std::forward<Args>(args)...);
     }
 } // namespace sf
 
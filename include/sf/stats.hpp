@@ -0,0 +1,109 @@
+/**StreamFormat stats.hpp
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2018-2020 Berrysoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+#ifndef SF_STATS_HPP
+#define SF_STATS_HPP
+
+#include <sf/utility.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <sf/format.hpp>
+#include <string>
+#include <vector>
+
+namespace sf
+{
+    namespace stats
+    {
+        //Statistics of a format string, summed over all threads.
+        struct entry
+        {
+            std::string format;
+            bool input;
+            std::uint64_t calls;
+            std::uint64_t bytes;
+            std::uint64_t nanoseconds;
+            std::uint64_t failures;
+        };
+
+        //Sorted by time, the most expensive first. Empty unless SF_ENABLE_STATS is defined.
+        inline std::vector<entry> snapshot()
+        {
+            std::vector<entry> result;
+#ifdef SF_ENABLE_STATS
+            internal::stats_registry::instance().for_each([&](internal::stats_site& site) {
+                std::size_t i = 0;
+                for (; i < result.size(); i++)
+                {
+                    if (result[i].format == site.format && result[i].input == site.input)
+                        break;
+                }
+                if (i == result.size())
+                    result.push_back({ site.format, site.input, 0, 0, 0, 0 });
+                result[i].calls += site.counters.calls.load(std::memory_order_relaxed);
+                result[i].bytes += site.counters.bytes.load(std::memory_order_relaxed);
+                result[i].nanoseconds += site.counters.nanoseconds.load(std::memory_order_relaxed);
+                result[i].failures += site.counters.failures.load(std::memory_order_relaxed);
+            });
+            std::stable_sort(result.begin(), result.end(), [](const entry& a, const entry& b) { return a.nanoseconds > b.nanoseconds; });
+#endif // SF_ENABLE_STATS
+            return result;
+        }
+
+        inline void reset()
+        {
+#ifdef SF_ENABLE_STATS
+            internal::stats_registry::instance().for_each([](internal::stats_site& site) {
+                site.counters.calls.store(0, std::memory_order_relaxed);
+                site.counters.bytes.store(0, std::memory_order_relaxed);
+                site.counters.nanoseconds.store(0, std::memory_order_relaxed);
+                site.counters.failures.store(0, std::memory_order_relaxed);
+            });
+#endif // SF_ENABLE_STATS
+        }
+
+        inline std::ostream& report(std::ostream& stream = std::clog)
+        {
+            std::vector<entry> entries = snapshot();
+            print(stream, "{:r12} {:r14} {:r14} {:r10}  {}\n", "calls", "bytes", "time(us)", "failures", "format");
+            for (const entry& e : entries)
+            {
+                std::string format;
+                for (char c : e.format)
+                {
+                    if (c == '\n')
+                        format += "\\n";
+                    else
+                        format += c;
+                }
+                print(stream, "{:r12} {:r14} {:f3,r14} {:r10}  {}{}\n", e.calls, e.bytes, e.nanoseconds / 1000.0, e.failures, e.input ? "scan: " : "print: ", format);
+            }
+            return stream;
+        }
+    } // namespace stats
+} // namespace sf
+
+#endif // !SF_STATS_HPP
@@ -0,0 +1,574 @@
+/**StreamFormat unicode.hpp
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2018-2020 Berrysoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+#ifndef SF_UNICODE_HPP
+#define SF_UNICODE_HPP
+
+#include <sf/utility.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <iterator>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#ifdef SF_HAS_SSE2
+    #include <emmintrin.h>
+#endif // SF_HAS_SSE2
+
+namespace sf
+{
+    namespace internal
+    {
+        //Char types without standard stream facets, which are transcoded through UTF-8.
+        template <typename Char>
+        struct is_utf_char : std::bool_constant<std::is_same_v<Char, char16_t> || std::is_same_v<Char, char32_t>
+#ifdef __cpp_char8_t
+                                                || std::is_same_v<Char, char8_t>
+#endif // __cpp_char8_t
+                                                >
+        {
+        };
+
+        template <typename Char>
+        inline constexpr bool is_utf_char_v = is_utf_char<Char>::value;
+
+        //Length of the leading ASCII run.
+        inline std::size_t ascii_prefix(const char* str, std::size_t len) noexcept
+        {
+            std::size_t i = 0;
+#ifdef SF_HAS_SSE2
+            for (; i + 16 <= len; i += 16)
+            {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i));
+                if (_mm_movemask_epi8(v))
+                    break;
+            }
+#endif // SF_HAS_SSE2
+            for (; i < len; i++)
+            {
+                if (static_cast<unsigned char>(str[i]) & 0x80)
+                    break;
+            }
+            return i;
+        }
+
+        //Length of the leading run of code units below 0x80.
+        template <typename Char>
+        std::size_t ascii_prefix(const Char* str, std::size_t len) noexcept
+        {
+            std::size_t i = 0;
+#ifdef SF_HAS_SSE2
+            if constexpr (sizeof(Char) == 2)
+            {
+                const __m128i mask = _mm_set1_epi16(static_cast<short>(0xFF80));
+                for (; i + 8 <= len; i += 8)
+                {
+                    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i));
+                    if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, mask), _mm_setzero_si128())) != 0xFFFF)
+                        break;
+                }
+            }
+            else if constexpr (sizeof(Char) == 4)
+            {
+                const __m128i mask = _mm_set1_epi32(static_cast<int>(0xFFFFFF80));
+                for (; i + 4 <= len; i += 4)
+                {
+                    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i));
+                    if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(v, mask), _mm_setzero_si128())) != 0xFFFF)
+                        break;
+                }
+            }
+#endif // SF_HAS_SSE2
+            for (; i < len; i++)
+            {
+                if (static_cast<std::uint32_t>(str[i]) >= 0x80)
+                    break;
+            }
+            return i;
+        }
+
+        //Zero extend ASCII bytes to wider code units.
+        template <typename Char>
+        Char* widen_ascii(const char* str, std::size_t len, Char* out) noexcept
+        {
+            std::size_t i = 0;
+#ifdef SF_HAS_SSE2
+            const __m128i zero = _mm_setzero_si128();
+            if constexpr (sizeof(Char) == 2)
+            {
+                for (; i + 16 <= len; i += 16)
+                {
+                    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_unpacklo_epi8(v, zero));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 8), _mm_unpackhi_epi8(v, zero));
+                }
+            }
+            else if constexpr (sizeof(Char) == 4)
+            {
+                for (; i + 16 <= len; i += 16)
+                {
+                    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i));
+                    __m128i lo = _mm_unpacklo_epi8(v, zero);
+                    __m128i hi = _mm_unpackhi_epi8(v, zero);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_unpacklo_epi16(lo, zero));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 4), _mm_unpackhi_epi16(lo, zero));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 8), _mm_unpacklo_epi16(hi, zero));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 12), _mm_unpackhi_epi16(hi, zero));
+                }
+            }
+#endif // SF_HAS_SSE2
+            for (; i < len; i++)
+            {
+                out[i] = static_cast<Char>(static_cast<unsigned char>(str[i]));
+            }
+            return out + len;
+        }
+
+        //Narrow code units known to be below 0x80.
+        template <typename Char>
+        char* narrow_ascii(const Char* str, std::size_t len, char* out) noexcept
+        {
+            std::size_t i = 0;
+#ifdef SF_HAS_SSE2
+            if constexpr (sizeof(Char) == 2)
+            {
+                for (; i + 16 <= len; i += 16)
+                {
+                    __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i));
+                    __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i + 8));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(lo, hi));
+                }
+            }
+            else if constexpr (sizeof(Char) == 4)
+            {
+                for (; i + 8 <= len; i += 8)
+                {
+                    __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i));
+                    __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i + 4));
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(_mm_packs_epi32(lo, hi), _mm_setzero_si128()));
+                }
+            }
+#endif // SF_HAS_SSE2
+            for (; i < len; i++)
+            {
+                out[i] = static_cast<char>(str[i]);
+            }
+            return out + len;
+        }
+
+        inline constexpr char32_t replacement_char = 0xFFFD;
+
+        //Decode one code point from UTF-8; invalid sequences become U+FFFD.
+        inline char32_t utf8_decode(const char*& it, const char* end) noexcept
+        {
+            unsigned char c = static_cast<unsigned char>(*it++);
+            if (c < 0x80)
+                return c;
+            int count;
+            char32_t cp;
+            if (c >= 0xC2 && c <= 0xDF)
+            {
+                count = 1;
+                cp = c & 0x1F;
+            }
+            else if (c >= 0xE0 && c <= 0xEF)
+            {
+                count = 2;
+                cp = c & 0x0F;
+            }
+            else if (c >= 0xF0 && c <= 0xF4)
+            {
+                count = 3;
+                cp = c & 0x07;
+            }
+            else
+            {
+                return replacement_char;
+            }
+            for (int i = 0; i < count; i++)
+            {
+                if (it == end || (static_cast<unsigned char>(*it) & 0xC0) != 0x80)
+                    return replacement_char;
+                cp = (cp << 6) | (static_cast<unsigned char>(*it++) & 0x3F);
+            }
+            if ((count == 2 && cp < 0x800) || (count == 3 && (cp < 0x10000 || cp > 0x10FFFF)) || (cp >= 0xD800 && cp <= 0xDFFF))
+                return replacement_char;
+            return cp;
+        }
+
+        struct code_point_range
+        {
+            char32_t first;
+            char32_t last;
+        };
+
+        //East Asian Wide (W) and Fullwidth (F) characters, which take two columns.
+        inline constexpr code_point_range wide_ranges[] = {
+            { 0x1100, 0x115F }, { 0x231A, 0x231B }, { 0x2329, 0x232A }, { 0x23E9, 0x23EC }, { 0x23F0, 0x23F0 }, { 0x23F3, 0x23F3 },
+            { 0x25FD, 0x25FE }, { 0x2614, 0x2615 }, { 0x2648, 0x2653 }, { 0x267F, 0x267F }, { 0x2693, 0x2693 }, { 0x26A1, 0x26A1 },
+            { 0x26AA, 0x26AB }, { 0x26BD, 0x26BE }, { 0x26C4, 0x26C5 }, { 0x26CE, 0x26CE }, { 0x26D4, 0x26D4 }, { 0x26EA, 0x26EA },
+            { 0x26F2, 0x26F3 }, { 0x26F5, 0x26F5 }, { 0x26FA, 0x26FA }, { 0x26FD, 0x26FD }, { 0x2705, 0x2705 }, { 0x270A, 0x270B },
+            { 0x2728, 0x2728 }, { 0x274C, 0x274C }, { 0x274E, 0x274E }, { 0x2753, 0x2755 }, { 0x2757, 0x2757 }, { 0x2795, 0x2797 },
+            { 0x27B0, 0x27B0 }, { 0x27BF, 0x27BF }, { 0x2B1B, 0x2B1C }, { 0x2B50, 0x2B50 }, { 0x2B55, 0x2B55 }, { 0x2E80, 0x3029 },
+            { 0x302E, 0x303E }, { 0x3041, 0x3098 }, { 0x309B, 0x33FF }, { 0x3400, 0x4DBF }, { 0x4E00, 0x9FFF }, { 0xA000, 0xA4CF },
+            { 0xA960, 0xA97F }, { 0xAC00, 0xD7A3 }, { 0xF900, 0xFAFF }, { 0xFE10, 0xFE19 }, { 0xFE30, 0xFE6F }, { 0xFF00, 0xFF60 },
+            { 0xFFE0, 0xFFE6 }, { 0x16FE0, 0x16FE4 }, { 0x17000, 0x18CFF }, { 0x1B000, 0x1B2FF }, { 0x1F004, 0x1F004 }, { 0x1F0CF, 0x1F0CF },
+            { 0x1F18E, 0x1F18E }, { 0x1F191, 0x1F19A }, { 0x1F200, 0x1F265 }, { 0x1F300, 0x1F320 }, { 0x1F32D, 0x1F335 }, { 0x1F337, 0x1F37C },
+            { 0x1F37E, 0x1F393 }, { 0x1F3A0, 0x1F3CA }, { 0x1F3CF, 0x1F3D3 }, { 0x1F3E0, 0x1F3F0 }, { 0x1F3F4, 0x1F3F4 }, { 0x1F3F8, 0x1F43E },
+            { 0x1F440, 0x1F440 }, { 0x1F442, 0x1F4FC }, { 0x1F4FF, 0x1F53D }, { 0x1F54B, 0x1F54E }, { 0x1F550, 0x1F567 }, { 0x1F57A, 0x1F57A },
+            { 0x1F595, 0x1F596 }, { 0x1F5A4, 0x1F5A4 }, { 0x1F5FB, 0x1F64F }, { 0x1F680, 0x1F6C5 }, { 0x1F6CC, 0x1F6CC }, { 0x1F6D0, 0x1F6D2 },
+            { 0x1F6D5, 0x1F6D7 }, { 0x1F6DC, 0x1F6DF }, { 0x1F6EB, 0x1F6EC }, { 0x1F6F4, 0x1F6FC }, { 0x1F7E0, 0x1F7EB }, { 0x1F7F0, 0x1F7F0 },
+            { 0x1F90C, 0x1F93A }, { 0x1F93C, 0x1F945 }, { 0x1F947, 0x1F9FF }, { 0x1FA70, 0x1FAFF }, { 0x20000, 0x2FFFD }, { 0x30000, 0x3FFFD }
+        };
+
+        //Combining marks, format characters and others which take no column.
+        inline constexpr code_point_range zero_width_ranges[] = {
+            { 0x0300, 0x036F }, { 0x0483, 0x0489 }, { 0x0591, 0x05BD }, { 0x05BF, 0x05BF }, { 0x05C1, 0x05C2 }, { 0x05C4, 0x05C5 },
+            { 0x05C7, 0x05C7 }, { 0x0610, 0x061A }, { 0x061C, 0x061C }, { 0x064B, 0x065F }, { 0x0670, 0x0670 }, { 0x06D6, 0x06DC },
+            { 0x06DF, 0x06E4 }, { 0x06E7, 0x06E8 }, { 0x06EA, 0x06ED }, { 0x0711, 0x0711 }, { 0x0730, 0x074A }, { 0x07A6, 0x07B0 },
+            { 0x07EB, 0x07F3 }, { 0x0816, 0x082D }, { 0x0859, 0x085B }, { 0x08D3, 0x0902 }, { 0x093A, 0x093A }, { 0x093C, 0x093C },
+            { 0x0941, 0x0948 }, { 0x094D, 0x094D }, { 0x0951, 0x0957 }, { 0x0962, 0x0963 }, { 0x0981, 0x0981 }, { 0x09BC, 0x09BC },
+            { 0x09C1, 0x09C4 }, { 0x09CD, 0x09CD }, { 0x09E2, 0x09E3 }, { 0x0A01, 0x0A02 }, { 0x0A3C, 0x0A3C }, { 0x0A41, 0x0A51 },
+            { 0x0A70, 0x0A71 }, { 0x0A75, 0x0A75 }, { 0x0A81, 0x0A82 }, { 0x0ABC, 0x0ABC }, { 0x0AC1, 0x0AC8 }, { 0x0ACD, 0x0ACD },
+            { 0x0B01, 0x0B01 }, { 0x0B3C, 0x0B3C }, { 0x0B3F, 0x0B3F }, { 0x0B41, 0x0B44 }, { 0x0B4D, 0x0B4D }, { 0x0BC0, 0x0BC0 },
+            { 0x0BCD, 0x0BCD }, { 0x0C3E, 0x0C40 }, { 0x0C46, 0x0C56 }, { 0x0CBC, 0x0CBC }, { 0x0CCC, 0x0CCD }, { 0x0D41, 0x0D44 },
+            { 0x0D4D, 0x0D4D }, { 0x0DCA, 0x0DCA }, { 0x0DD2, 0x0DD6 }, { 0x0E31, 0x0E31 }, { 0x0E34, 0x0E3A }, { 0x0E47, 0x0E4E },
+            { 0x0EB1, 0x0EB1 }, { 0x0EB4, 0x0EBC }, { 0x0EC8, 0x0ECD }, { 0x0F18, 0x0F19 }, { 0x0F35, 0x0F35 }, { 0x0F37, 0x0F37 },
+            { 0x0F39, 0x0F39 }, { 0x0F71, 0x0F7E }, { 0x0F80, 0x0F84 }, { 0x0F86, 0x0F87 }, { 0x0F8D, 0x0FBC }, { 0x102D, 0x1030 },
+            { 0x1032, 0x1037 }, { 0x1039, 0x103A }, { 0x1160, 0x11FF }, { 0x135D, 0x135F }, { 0x1712, 0x1714 }, { 0x17B4, 0x17B5 },
+            { 0x17B7, 0x17BD }, { 0x17C6, 0x17C6 }, { 0x17C9, 0x17D3 }, { 0x180B, 0x180F }, { 0x1AB0, 0x1AFF }, { 0x1DC0, 0x1DFF },
+            { 0x200B, 0x200F }, { 0x2028, 0x202E }, { 0x2060, 0x2064 }, { 0x20D0, 0x20F0 }, { 0x2CEF, 0x2CF1 }, { 0x2DE0, 0x2DFF },
+            { 0x302A, 0x302D }, { 0x3099, 0x309A }, { 0xA66F, 0xA672 }, { 0xA674, 0xA67D }, { 0xA69E, 0xA69F }, { 0xA6F0, 0xA6F1 },
+            { 0xFE00, 0xFE0F }, { 0xFE20, 0xFE2F }, { 0xFEFF, 0xFEFF }, { 0x1F3FB, 0x1F3FF }, { 0xE0000, 0xE0FFF }
+        };
+
+        inline bool in_ranges(char32_t cp, const code_point_range* ranges, std::size_t count) noexcept
+        {
+            std::size_t low = 0, high = count;
+            while (low < high)
+            {
+                std::size_t mid = (low + high) / 2;
+                if (cp < ranges[mid].first)
+                    high = mid;
+                else if (cp > ranges[mid].last)
+                    low = mid + 1;
+                else
+                    return true;
+            }
+            return false;
+        }
+
+        //Columns of a code point in a terminal, as wcwidth gives.
+        inline std::size_t display_width(char32_t cp) noexcept
+        {
+            if (cp < 0x20 || (cp >= 0x7F && cp < 0xA0))
+                return 0;
+            if (cp < 0x300)
+                return 1;
+            //CJK ideographs and Hangul syllables. Kana hold combining marks, and the Yijing
+            //hexagrams before the ideographs are narrow, so they are looked up.
+            if ((cp >= 0x4E00 && cp <= 0x9FFF) || (cp >= 0xAC00 && cp <= 0xD7A3))
+                return 2;
+            if (in_ranges(cp, zero_width_ranges, std::size(zero_width_ranges)))
+                return 0;
+            if (in_ranges(cp, wide_ranges, std::size(wide_ranges)))
+                return 2;
+            return 1;
+        }
+
+        //Columns of UTF-8 text. ASCII runs are skipped 16 bytes at a time.
+        inline std::size_t display_width(const char* str, std::size_t len) noexcept
+        {
+            const char* it = str;
+            const char* const end = str + len;
+            std::size_t width = 0;
+            while (it != end)
+            {
+                std::size_t ascii = ascii_prefix(it, static_cast<std::size_t>(end - it));
+                width += ascii;
+                it += ascii;
+                if (it != end)
+                    width += display_width(utf8_decode(it, end));
+            }
+            return width;
+        }
+
+        //Decode one code point from UTF-16 or UTF-32, chosen by the size of Char.
+        template <typename Char>
+        char32_t utf_decode(const Char*& it, const Char* end) noexcept
+        {
+            char32_t c = static_cast<char32_t>(*it++);
+            if constexpr (sizeof(Char) == 2)
+            {
+                c &= 0xFFFF;
+                if (c >= 0xD800 && c <= 0xDBFF)
+                {
+                    if (it != end)
+                    {
+                        char32_t low = static_cast<char32_t>(*it) & 0xFFFF;
+                        if (low >= 0xDC00 && low <= 0xDFFF)
+                        {
+                            it++;
+                            return 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+                        }
+                    }
+                    return replacement_char;
+                }
+                else if (c >= 0xDC00 && c <= 0xDFFF)
+                {
+                    return replacement_char;
+                }
+                return c;
+            }
+            else
+            {
+                if (c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF))
+                    return replacement_char;
+                return c;
+            }
+        }
+
+        //Encode one code point to UTF-8, UTF-16 or UTF-32, chosen by the size of Char.
+        template <typename Char>
+        Char* utf_encode(char32_t cp, Char* out) noexcept
+        {
+            if constexpr (sizeof(Char) == 1)
+            {
+                if (cp < 0x80)
+                {
+                    *out++ = static_cast<Char>(cp);
+                }
+                else if (cp < 0x800)
+                {
+                    *out++ = static_cast<Char>(0xC0 | (cp >> 6));
+                    *out++ = static_cast<Char>(0x80 | (cp & 0x3F));
+                }
+                else if (cp < 0x10000)
+                {
+                    *out++ = static_cast<Char>(0xE0 | (cp >> 12));
+                    *out++ = static_cast<Char>(0x80 | ((cp >> 6) & 0x3F));
+                    *out++ = static_cast<Char>(0x80 | (cp & 0x3F));
+                }
+                else
+                {
+                    *out++ = static_cast<Char>(0xF0 | (cp >> 18));
+                    *out++ = static_cast<Char>(0x80 | ((cp >> 12) & 0x3F));
+                    *out++ = static_cast<Char>(0x80 | ((cp >> 6) & 0x3F));
+                    *out++ = static_cast<Char>(0x80 | (cp & 0x3F));
+                }
+            }
+            else if constexpr (sizeof(Char) == 2)
+            {
+                if (cp < 0x10000)
+                {
+                    *out++ = static_cast<Char>(cp);
+                }
+                else
+                {
+                    cp -= 0x10000;
+                    *out++ = static_cast<Char>(0xD800 + (cp >> 10));
+                    *out++ = static_cast<Char>(0xDC00 + (cp & 0x3FF));
+                }
+            }
+            else
+            {
+                *out++ = static_cast<Char>(cp);
+            }
+            return out;
+        }
+
+        //Append UTF-8 text to a string of Char code units.
+        template <typename Char, typename Traits, typename Allocator>
+        void utf8_append(std::basic_string<Char, Traits, Allocator>& out, std::string_view str)
+        {
+            const std::size_t old = out.size();
+            out.resize(old + str.length());
+            if constexpr (sizeof(Char) == 1)
+            {
+                std::memcpy(out.data() + old, str.data(), str.length());
+            }
+            else
+            {
+                //Every UTF-8 sequence yields no more code units than its length in bytes.
+                Char* dest = out.data() + old;
+                const char* it = str.data();
+                const char* end = it + str.length();
+                while (it != end)
+                {
+                    std::size_t len = ascii_prefix(it, static_cast<std::size_t>(end - it));
+                    dest = widen_ascii(it, len, dest);
+                    it += len;
+                    if (it != end)
+                        dest = utf_encode(utf8_decode(it, end), dest);
+                }
+                out.resize(static_cast<std::size_t>(dest - out.data()));
+            }
+        }
+
+        //Append Char code units to a UTF-8 string.
+        template <typename Char>
+        void utf8_encode_append(std::string& out, const Char* str, std::size_t len)
+        {
+            const std::size_t old = out.size();
+            if constexpr (sizeof(Char) == 1)
+            {
+                out.resize(old + len);
+                std::memcpy(out.data() + old, str, len);
+            }
+            else
+            {
+                out.resize(old + len * (sizeof(Char) == 2 ? 3 : 4));
+                char* dest = out.data() + old;
+                const Char* it = str;
+                const Char* end = str + len;
+                while (it != end)
+                {
+                    std::size_t n = ascii_prefix(it, static_cast<std::size_t>(end - it));
+                    dest = narrow_ascii(it, n, dest);
+                    it += n;
+                    if (it != end)
+                        dest = utf_encode(utf_decode(it, end), dest);
+                }
+                out.resize(static_cast<std::size_t>(dest - out.data()));
+            }
+        }
+
+        //The code unit type of a string argument, or void.
+        template <typename T>
+        struct string_char
+        {
+            using type = void;
+        };
+        template <typename Char, typename Traits, typename Allocator>
+        struct string_char<std::basic_string<Char, Traits, Allocator>>
+        {
+            using type = Char;
+        };
+        template <typename Char, typename Traits>
+        struct string_char<std::basic_string_view<Char, Traits>>
+        {
+            using type = Char;
+        };
+        template <typename Char>
+        struct string_char<Char*>
+        {
+            using type = std::remove_const_t<Char>;
+        };
+
+        template <typename T>
+        using string_char_t = typename string_char<std::decay_t<T>>::type;
+
+        //Strings and characters which a narrow stream cannot output as text.
+        template <typename Char>
+        inline constexpr bool is_transcoded_char_v = is_utf_char_v<Char> || std::is_same_v<Char, wchar_t>;
+
+        template <typename T>
+        std::string to_utf8_arg(const T& arg)
+        {
+            using char_type = string_char_t<T>;
+            std::string result;
+            if constexpr (std::is_pointer_v<std::decay_t<T>>)
+                utf8_encode_append(result, arg, std::char_traits<char_type>::length(arg));
+            else
+                utf8_encode_append(result, arg.data(), arg.size());
+            return result;
+        }
+
+        //Replace a unicode string or character argument with its UTF-8 form.
+        template <typename T>
+        decltype(auto) utf8_output_arg(T&& arg)
+        {
+            using type = std::remove_cv_t<std::remove_reference_t<T>>;
+            if constexpr (is_transcoded_char_v<string_char_t<T>>)
+            {
+                return to_utf8_arg(arg);
+            }
+            else if constexpr (is_transcoded_char_v<type>)
+            {
+                std::string result;
+                utf8_encode_append(result, &arg, 1);
+                return result;
+            }
+            else
+            {
+                return std::forward<T>(arg);
+            }
+        }
+
+        //Read a UTF-8 word and store it to a unicode string.
+        template <typename Char, typename Traits, typename Allocator>
+        class utf8_string_input
+        {
+        private:
+            std::basic_string<Char, Traits, Allocator>& arg;
+
+        public:
+            constexpr utf8_string_input(std::basic_string<Char, Traits, Allocator>& arg) noexcept : arg(arg) {}
+            friend std::istream& operator>>(std::istream& stream, utf8_string_input& in)
+            {
+                std::string str;
+                if (stream >> str)
+                {
+                    in.arg.clear();
+                    utf8_append(in.arg, str);
+                }
+                return stream;
+            }
+        };
+
+        //Replace a unicode string reference with a UTF-8 reading proxy.
+        template <typename T>
+        decltype(auto) utf8_input_arg(T&& arg)
+        {
+            using type = std::remove_reference_t<T>;
+            if constexpr (std::is_lvalue_reference_v<T> && !std::is_const_v<type> && !std::is_pointer_v<type> && is_transcoded_char_v<string_char_t<type>>)
+                return utf8_string_input(arg);
+            else
+                return std::forward<T>(arg);
+        }
+    } // namespace internal
+
+    template <typename Char, typename Traits = std::char_traits<Char>, typename Allocator = std::allocator<Char>>
+    std::basic_string<Char, Traits, Allocator> from_utf8(std::string_view str)
+    {
+        std::basic_string<Char, Traits, Allocator> result;
+        internal::utf8_append(result, str);
+        return result;
+    }
+
+    template <typename Char, typename Traits = std::char_traits<Char>>
+    std::string to_utf8(std::basic_string_view<Char, Traits> str)
+    {
+        std::string result;
+        internal::utf8_encode_append(result, str.data(), str.length());
+        return result;
+    }
+} // namespace sf
+
+#endif // !SF_UNICODE_HPP
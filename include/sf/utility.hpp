@@ -36,4 +36,12 @@
     #error "StreamFormat needs at least C++ 17"
 #endif // Less than C++ 17
 
+//Vectorised kernels are used when the target supports SSE2.
+//Define SF_NO_SIMD to force the scalar fallbacks.
+#ifndef SF_NO_SIMD
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define SF_HAS_SSE2
+    #endif // SSE2
+#endif // !SF_NO_SIMD
+
 #endif // !SF_UTILITY_HPP
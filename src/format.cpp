@@ -0,0 +1,57 @@
+/**StreamFormat format.cpp
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2018-2020 Berrysoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+#include <sf/format.hpp>
+
+namespace sf
+{
+    namespace internal
+    {
+        template class string_view_io<input, char, std::char_traits<char>>;
+        template class string_view_io<output, char, std::char_traits<char>>;
+        template class string_view_io<input, wchar_t, std::char_traits<wchar_t>>;
+        template class string_view_io<output, wchar_t, std::char_traits<wchar_t>>;
+
+        template struct format_setf<input, char, std::char_traits<char>>;
+        template struct format_setf<output, char, std::char_traits<char>>;
+        template struct format_setf<input, wchar_t, std::char_traits<wchar_t>>;
+        template struct format_setf<output, wchar_t, std::char_traits<wchar_t>>;
+
+        template class format_arg_io<input, char, std::char_traits<char>>;
+        template class format_arg_io<output, char, std::char_traits<char>>;
+        template class format_arg_io<input, wchar_t, std::char_traits<wchar_t>>;
+        template class format_arg_io<output, wchar_t, std::char_traits<wchar_t>>;
+
+        template class format_string_view<input, char, std::char_traits<char>>;
+        template class format_string_view<output, char, std::char_traits<char>>;
+        template class format_string_view<input, wchar_t, std::char_traits<wchar_t>>;
+        template class format_string_view<output, wchar_t, std::char_traits<wchar_t>>;
+
+        template std::istream& vformat<input, char, std::char_traits<char>>(std::istream&, std::string_view, arg_list_t<std::istream>&&, const std::string_view*);
+        template std::ostream& vformat<output, char, std::char_traits<char>>(std::ostream&, std::string_view, arg_list_t<std::ostream>&&, const std::string_view*);
+        template std::wistream& vformat<input, wchar_t, std::char_traits<wchar_t>>(std::wistream&, std::wstring_view, arg_list_t<std::wistream>&&, const std::wstring_view*);
+        template std::wostream& vformat<output, wchar_t, std::char_traits<wchar_t>>(std::wostream&, std::wstring_view, arg_list_t<std::wostream>&&, const std::wstring_view*);
+    } // namespace internal
+} // namespace sf
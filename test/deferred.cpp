@@ -0,0 +1,54 @@
+#include <cstdio>
+#include <filesystem>
+#include <sf/deferred.hpp>
+#include <sf/sformat.hpp>
+
+using namespace sf;
+using namespace std;
+
+int main()
+{
+    //The logs go to the temporary directory and are removed at the end.
+    const string path = (filesystem::temp_directory_path() / "sf_deferred_test.sfl").string();
+    const string bad_path = (filesystem::temp_directory_path() / "sf_deferred_bad.sfl").string();
+    string name = "tick";
+    int x = 0;
+    {
+        deferred_writer writer(path.c_str(), 64);
+        for (int i = 0; i < 10; i++)
+        {
+            writer.print("{} {:x4} {:f3} {}\n", name, i * 17, i * 0.5, i % 2 == 0);
+        }
+        writer.println("{0:c} {1} {2:s,x}|{3}", 'x', static_cast<const void*>(&x), 255ull, "literal");
+    }
+    string expected;
+    for (int i = 0; i < 10; i++)
+    {
+        expected += sprint("{} {:x4} {:f3} {}\n", name, i * 17, i * 0.5, i % 2 == 0);
+    }
+    expected += sprint("{0:c} {1} {2:s,x}|{3}\n", 'x', static_cast<const void*>(&x), 255ull, "literal");
+    ostringstream oss;
+    bool ok;
+    {
+        deferred_reader reader(path.c_str());
+        ok = reader.replay(oss) && oss.str() == expected;
+        //A second replay gives the same text.
+        ostringstream again;
+        ok = ok && reader.replay(again) && again.str() == expected;
+    }
+    //A format id out of order, as a huge one in a corrupted file, is rejected.
+    {
+        FILE* file = fopen(bad_path.c_str(), "wb");
+        const char bad[] = { 'S', 'F', 'D', 'L', 1, 'F', '\xff', '\xff', '\xff', '\x7f', 1, 0, 0, 0, 'x' };
+        fwrite(bad, 1, sizeof(bad), file);
+        fclose(file);
+    }
+    ostringstream ignored;
+    ok = ok && !deferred_reader(bad_path.c_str()).replay(ignored);
+    ok = filesystem::remove(path) && filesystem::remove(bad_path) && ok;
+    if (ok)
+    {
+        print("Success.\n");
+    }
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include <sf/fast_input.hpp>
+#include <sf/sformat.hpp>
+#include <thread>
+#include <vector>
+
+#if __has_include(<unistd.h>)
+    #include <unistd.h>
+#endif
+
+using namespace sf;
+using namespace std;
+
+//Write the text to a pipe in small chunks from another thread, splitting numbers and UTF-8.
+template <typename F>
+static bool with_pipe(const string& text, F&& f)
+{
+#if __has_include(<unistd.h>)
+    int fds[2];
+    if (pipe(fds) != 0)
+        return false;
+    thread writer([&]() {
+        for (size_t i = 0; i < text.length();)
+        {
+            size_t len = min<size_t>(1 + i % 5, text.length() - i);
+            if (write(fds[1], text.data() + i, len) < 0)
+                break;
+            i += len;
+        }
+        close(fds[1]);
+    });
+    bool ok = f(fds[0]);
+    writer.join();
+    close(fds[0]);
+    return ok;
+#else
+    return true;
+#endif
+}
+
+//Scan the same text from a fast_input and an istringstream.
+static bool same_as_stream(const string& text)
+{
+    return with_pipe(text, [&](int fd) {
+        fast_input in(fd, 16);
+        istringstream iss(text);
+        while (true)
+        {
+            int a = -1, b = -1, c = -1;
+            unsigned u = 1;
+            double d = -1, e = -1;
+            string s, t;
+            scan(in, "{} {:x} {} {} {} {} {} {}", a, b, c, u, d, e, s, t);
+            int a2 = -1, b2 = -1, c2 = -1;
+            unsigned u2 = 1;
+            double d2 = -1, e2 = -1;
+            string s2, t2;
+            scan(iss, "{} {:x} {} {} {} {} {} {}", a2, b2, c2, u2, d2, e2, s2, t2);
+            if (a != a2 || b != b2 || c != c2 || u != u2 || d != d2 || e != e2 || s != s2 || t != t2 || in.rdstate() != iss.rdstate())
+                return false;
+            if (!in)
+                return true;
+        }
+    });
+}
+
+int main()
+{
+    bool ok = true;
+    string text;
+    for (int i = 0; i < 100; i++)
+        text += sprint("{} {:x} {} {} {} {} word{} {}\n", i * 12345 - 600000, i * 31, -i, i * 7u, i * 0.125, 1e-5 * i + 3.75, i, "x");
+    ok = ok && same_as_stream(text);
+    //Input which from_chars and num_get read differently falls back to operator>>.
+    ok = ok && same_as_stream("1 ff 2 3 inf 4 a b");
+    ok = ok && same_as_stream("1 ff 2 3 1.5e+x 4 a b");
+    ok = ok && same_as_stream("99999999999 1 2 3 4 5 a b");
+    ok = ok && same_as_stream("1 2 3 -4 .5 6. a b");
+    ok = ok && same_as_stream("1 2 3 4 5 6 a 7");
+    //The sign comes before the 0x prefix, and a prefix without digits fails.
+    ok = ok && same_as_stream("1 -0x10 2 3 4 5 a b");
+    ok = ok && same_as_stream("1 0x 2 3 4 5 a b");
+    //Lists parsed in the buffer continue across blocks.
+    string list;
+    vector<long long> expected;
+    for (int i = 0; i < 500; i++)
+    {
+        expected.push_back((i % 2 ? -1 : 1) * (i * 1234567891LL % 99999999999LL));
+        list += sprint("{}{}", i ? ", " : "", expected.back());
+    }
+    ok = ok && with_pipe(list + "\nnext", [&](int fd) {
+        fast_input in(fd, 16);
+        vector<long long> values;
+        string next;
+        scan(in, "{:[sep=,]}\n{}", values, next);
+        return values == expected && next == "next";
+    });
+    //A wide stream decodes UTF-8 split across reads.
+    ok = ok && with_pipe("\xe4\xbd\xa0\xe5\xa5\xbd 42 \xf0\x9f\x98\x80 2.5", [](int fd) {
+        wfast_input in(fd, 16);
+        wstring w, e;
+        int n = 0;
+        double d = 0;
+        wscan(in, L"{} {} {} {}", w, n, e, d);
+        return w == L"你好" && n == 42 && e == L"\U0001F600" && d == 2.5 && in.eof();
+    });
+#if __has_include(<unistd.h>)
+    //A failed read sets badbit instead of eofbit, on the stream and through a plain istream.
+    {
+        fast_input in(-1, 16);
+        int n = 0;
+        scan(in, "{}", n);
+        ok = ok && in.bad() && !in.eof() && in.rdbuf()->error() == EBADF;
+        fd_streambuf buf(-1, 16);
+        istream is(&buf);
+        is.get();
+        ok = ok && is.bad() && buf.error() == EBADF;
+    }
+#endif
+    //The standard input flushes std::cout first, as std::cin does.
+    ok = ok && fast_stdin().tie() == &cout;
+    if (ok)
+    {
+        print("Success.\n");
+    }
+    return 0;
+}
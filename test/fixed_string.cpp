@@ -0,0 +1,39 @@
+#include <sf/fixed_string.hpp>
+#include <sf/sformat.hpp>
+
+using namespace sf;
+using namespace std;
+
+constexpr auto banner = fixed_sprint<64>("{0:l8}|{1:x8,s}|{2:r6}|{3:b}|{{{4}}}", "name", 0xbeefu, -42, true, 'c');
+static_assert(banner == "name    |000xbeef|   -42|true|{c}");
+static_assert(fixed_sprint<16>("{:i6}{:u,x}{}", -7, 255, 1) == "-    7FF1");
+static_assert(fixed_sprint<16>("{1}{0}{5}", 1, 2) == "21{5}");
+static_assert(fixed_sprint<8>(L"{:o,s}", 8) == L"010");
+
+int main()
+{
+    int n = 12345;
+    auto s = fixed_sprint<48>("{:d8}:{}:{:l4}|", n, banner, 'x');
+    bool ok = s == sprint("{:d8}:{}:{:l4}|", n, string_view(banner), 'x') && s.capacity() == 48;
+    ok = ok && sprint("[{}]", fixed_sprint<4>("{}", 42)) == "[42]";
+    ok = ok && fixed_sprint<64>("{0:l8}|{1:x8,s}|{2:r6}|{3:b}|{{{4}}}", "name", 0xbeefu, -42, true, 'c') == sprint("{0:l8}|{1:x8,s}|{2:r6}|{3:b}|{{{4}}}", "name", 0xbeefu, -42, true, 'c');
+    //Both engines read the same flags, including those followed by other characters.
+    for (const char* spec : { "x8", "x8a", "l6,[sep=,]", "d4x,r9", "i8,s,x", "r", "u,x,s", "l5,r7", "o,b" })
+    {
+        const string fmt = sprint("<{{:{}}}|{{:{}}}|{{:{}}}>", spec, spec, spec);
+        ok = ok && fixed_sprint<64>(string_view(fmt), -300, true, "ab") == sprint(fmt, -300, true, "ab");
+    }
+    try
+    {
+        fixed_sprint<4>("{}", 123456);
+        ok = false;
+    }
+    catch (const length_error&)
+    {
+    }
+    if (ok)
+    {
+        print("Success.\n");
+    }
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include <sf/scan_pattern.hpp>
+#include <sf/sformat.hpp>
+
+using namespace sf;
+using namespace std;
+
+//Prices in cents, printed with two decimals and parsed back.
+struct price
+{
+    long cents;
+};
+
+//An ID printed as "#" and 6 hex digits, or in decimal with the "dec" flag.
+struct order_id
+{
+    unsigned value;
+};
+
+template <>
+struct sf::formatter<price, char>
+{
+    static size_t digits(long v)
+    {
+        size_t n = 1;
+        for (; v >= 10; v /= 10)
+            n++;
+        return n;
+    }
+
+    size_t size(const price& p) const { return (p.cents < 0) + digits(p.cents < 0 ? -p.cents : p.cents) + 1 + (p.cents < 100 && p.cents > -100); }
+
+    template <typename OutputIt>
+    OutputIt format(const price& p, OutputIt out) const
+    {
+        long v = p.cents < 0 ? -p.cents : p.cents;
+        if (p.cents < 0)
+            *out++ = '-';
+        char buf[24];
+        char* end = buf + sizeof(buf);
+        char* it = end;
+        do
+        {
+            *--it = static_cast<char>('0' + v % 10);
+            v /= 10;
+        } while (v || end - it < 3);
+        for (; it != end - 2; ++it)
+            *out++ = *it;
+        *out++ = '.';
+        *out++ = end[-2];
+        *out++ = end[-1];
+        return out;
+    }
+};
+
+template <>
+struct sf::formatter<order_id, char>
+{
+    bool dec = false;
+
+    void parse(string_view spec) { dec = spec.find("dec") != string_view::npos; }
+
+    template <typename OutputIt>
+    OutputIt format(const order_id& id, OutputIt out) const
+    {
+        *out++ = '#';
+        string digits = dec ? to_string(id.value) : sprint("{:x6}", id.value);
+        for (char c : digits)
+            *out++ = c;
+        return out;
+    }
+};
+
+template <>
+struct sf::scanner<price, char>
+{
+    template <typename InputIt>
+    bool scan(InputIt& first, InputIt last, price& p) const
+    {
+        long units = 0, frac = 0;
+        int n = 0, f = 0;
+        for (; first != last && *first >= '0' && *first <= '9'; ++first, n++)
+            units = units * 10 + (*first - '0');
+        if (n == 0 || first == last || *first != '.')
+            return false;
+        for (++first; first != last && f < 2 && *first >= '0' && *first <= '9'; ++first, f++)
+            frac = frac * 10 + (*first - '0');
+        p.cents = units * 100 + frac;
+        return f == 2;
+    }
+};
+
+int main()
+{
+    bool ok = sprint("{} {} {}", price{ 123456 }, price{ 5 }, price{ -250 }) == "1234.56 0.05 -2.50";
+    //Padding uses size() when it is given, and a buffer otherwise.
+    ok = ok && sprint("[{:r8}|{:l10}]", price{ 1999 }, order_id{ 0xbeef }) == "[   19.99|#00beef   ]";
+    ok = ok && sprint("{:dec,r9}", order_id{ 48879 }) == "   #48879";
+    price a{}, b{};
+    int n = 0;
+    auto pos = sscan("  12.50 x3 7.25 end", "{} x{} {}", a, n, b);
+    ok = ok && a.cents == 1250 && n == 3 && b.cents == 725 && pos == streampos(15);
+    ok = ok && sscan("12.5 x", "{} x", a) == streampos(-1);
+    scan_pattern<char> pattern("{}@{}");
+    ok = ok && pattern.match("3@0.99", n, a) && n == 3 && a.cents == 99;
+    if (ok)
+    {
+        print("Success.\n");
+    }
+    return 0;
+}
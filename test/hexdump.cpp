@@ -0,0 +1,39 @@
+#include <array>
+#include <sf/sformat.hpp>
+#include <vector>
+
+using namespace sf;
+using namespace std;
+
+int main()
+{
+    vector<unsigned char> v;
+    for (int i = 0; i < 40; i++)
+    {
+        v.push_back(static_cast<unsigned char>(i * 7 + 30));
+    }
+    bool ok = sprint("{}", vector<unsigned char>{ 0x00, 0x7f, 0xff }) == "00 7f ff";
+    ok = ok && sprint("{:h,a,p}", v) ==
+                   "00000000  1e 25 2c 33 3a 41 48 4f 56 5d 64 6b 72 79 80 87  |.%,3:AHOV]dkry..|\n"
+                   "00000010  8e 95 9c a3 aa b1 b8 bf c6 cd d4 db e2 e9 f0 f7  |................|\n"
+                   "00000020  fe 05 0c 13 1a 21 28 2f                          |.....!(/|";
+    ok = ok && sprint("{:h8,w4,u}", v) == "1E252C33 3A41484F\n565D646B 72798087\n8E959CA3 AAB1B8BF\nC6CDD4DB E2E9F0F7\nFE050C13 1A21282F";
+    ok = ok && sprint("{:w0}|{}", array<byte, 3>{ byte{ 1 }, byte{ 0xab }, byte{ 0xff } }, make_bytes("xyz", 3)) == "01abff|78 79 7a";
+    string s = "hello";
+    ok = ok && sprint("{}|{:h}|{:l6}|{}", s, s, s, 42) == "hello|68 65 6c 6c 6f|hello |42";
+    ok = ok && wsprint(L"{:w2}", s) == L"6865 6c6c 6f";
+    //Multiples of 16 bytes go through the vectorised kernel.
+    vector<unsigned char> all(256);
+    string expected;
+    for (int i = 0; i < 256; i++)
+    {
+        all[i] = static_cast<unsigned char>(i);
+        expected += sprint("{:x2}", i);
+    }
+    ok = ok && sprint("{:w0}", all) == expected;
+    if (ok)
+    {
+        print("Success.\n");
+    }
+    return 0;
+}
@@ -0,0 +1,177 @@
+#include <sf/incremental_scanner.hpp>
+#include <sf/sformat.hpp>
+#include <thread>
+#include <vector>
+
+#if __has_include(<unistd.h>)
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <unistd.h>
+#endif
+
+using namespace sf;
+using namespace std;
+
+struct record
+{
+    int id;
+    string name;
+    double value;
+};
+
+static string make_input(int n)
+{
+    string input;
+    for (int i = 0; i < n; i++)
+    {
+        input += sprint("id={} name=item{} value={}\n", i, i * 7, i * 0.5);
+    }
+    return input;
+}
+
+static bool check(const vector<record>& records, int n)
+{
+    if (records.size() != static_cast<size_t>(n))
+        return false;
+    for (int i = 0; i < n; i++)
+    {
+        if (records[i].id != i || records[i].name != sprint("item{}", i * 7) || records[i].value != i * 0.5)
+            return false;
+    }
+    return true;
+}
+
+//Feed a non-blocking pipe, written in small chunks by another thread.
+static bool test_pipe()
+{
+#if __has_include(<unistd.h>)
+    const int n = 200;
+    int fds[2];
+    if (pipe(fds) != 0)
+        return false;
+    string input = make_input(n);
+    thread writer([&]() {
+        for (size_t i = 0; i < input.length();)
+        {
+            size_t len = min<size_t>(1 + i % 7, input.length() - i);
+            if (write(fds[1], input.data() + i, len) < 0)
+                break;
+            i += len;
+        }
+        close(fds[1]);
+    });
+    fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+    incremental_scanner scanner("id={} name={} value={}\n");
+    vector<record> records;
+    record r;
+    bool ok = true;
+    while (true)
+    {
+        pollfd p{ fds[0], POLLIN, 0 };
+        poll(&p, 1, -1);
+        char buf[5];
+        ssize_t len = read(fds[0], buf, sizeof(buf));
+        if (len == 0)
+            break;
+        if (len < 0)
+            continue;
+        if (scanner.feed(string_view(buf, static_cast<size_t>(len)), [&]() { records.push_back(r); }, r.id, r.name, r.value) == scan_status::error)
+            ok = false;
+    }
+    writer.join();
+    close(fds[0]);
+    scanner.finish();
+    ok = ok && scanner.next(r.id, r.name, r.value) == scan_status::need_more;
+    return ok && check(records, n);
+#else
+    return true;
+#endif
+}
+
+//A number at the end of a chunk may continue in the next one.
+static bool test_split()
+{
+    incremental_scanner scanner("{} {}");
+    int a = 0, b = 0;
+    scanner.feed("12");
+    bool ok = scanner.next(a, b) == scan_status::need_more;
+    scanner.feed("3 45");
+    ok = ok && scanner.next(a, b) == scan_status::need_more && a == 123;
+    scanner.feed("6 7");
+    ok = ok && scanner.next(a, b) == scan_status::complete && a == 123 && b == 456;
+    scanner.finish();
+    ok = ok && scanner.next(a, b) == scan_status::error && scanner.result().field == 1 && scanner.pending() == " 7";
+    //A chunk which ends in the spaces between fields.
+    incremental_scanner spaced("id={} name={}\n");
+    string name;
+    spaced.feed("id=1 ");
+    ok = ok && spaced.next(a, name) == scan_status::need_more;
+    spaced.feed(" name=x\n");
+    ok = ok && spaced.next(a, name) == scan_status::complete && a == 1 && name == "x";
+    //A number split inside its token, after the sign, the prefix or the exponent.
+    incremental_scanner numbers("{} {:x} {}\n");
+    unsigned h = 0;
+    double d = 0;
+    numbers.feed("-");
+    ok = ok && numbers.next(a, h, d) == scan_status::need_more;
+    numbers.feed("12 0x");
+    ok = ok && numbers.next(a, h, d) == scan_status::need_more;
+    numbers.feed("1f 1e");
+    ok = ok && numbers.next(a, h, d) == scan_status::need_more;
+    numbers.feed("5\n");
+    ok = ok && numbers.next(a, h, d) == scan_status::complete && a == -12 && h == 31 && d == 1e5;
+    incremental_scanner bad("[{}]");
+    bad.feed("[1)");
+    return ok && bad.next(a) == scan_status::error && bad.result().field == scan_result::npos && bad.result().position == 2;
+}
+
+#ifdef __cpp_impl_coroutine
+struct task
+{
+    struct promise_type
+    {
+        task get_return_object() { return {}; }
+        suspend_never initial_suspend() noexcept { return {}; }
+        suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { terminate(); }
+    };
+};
+
+static task consume(incremental_scanner& scanner, vector<record>& records)
+{
+    record r;
+    while (co_await scanner.async_next(r.id, r.name, r.value) == scan_status::complete)
+    {
+        records.push_back(r);
+    }
+}
+#endif // __cpp_impl_coroutine
+
+static bool test_coroutine()
+{
+#ifdef __cpp_impl_coroutine
+    const int n = 50;
+    incremental_scanner scanner("id={} name={} value={}\n");
+    vector<record> records;
+    consume(scanner, records);
+    string input = make_input(n);
+    for (char c : input)
+    {
+        scanner.feed(string_view(&c, 1));
+    }
+    scanner.finish();
+    return check(records, n);
+#else
+    return true;
+#endif // __cpp_impl_coroutine
+}
+
+int main()
+{
+    if (test_pipe() && test_split() && test_coroutine())
+    {
+        print("Success.\n");
+    }
+    return 0;
+}
@@ -0,0 +1,29 @@
+#include <sf/named.hpp>
+
+using namespace sf;
+using namespace std;
+
+int main()
+{
+    ostringstream oss;
+    print(oss, "{user} is {age:x4} {}; {missing}\n", sf::arg("user", "bob"), sf::arg("age", 42), 7);
+    static const named_format fmt("{name}: {value:f2}\n", { "name", "value" });
+    print(oss, fmt, "pi", 3.14159);
+    int a = 0;
+    string w;
+    sscan("xyz 12", "{w} {n}", sf::arg("n", a), sf::arg("w", w));
+    print(oss, "{} {}\n", w, a);
+#ifdef SF_HAS_STATIC_NAMES
+    print(oss, named<"{b}-{a}-{b:x}\n">, sf::arg<"a">(10), sf::arg<"b">(11));
+    oss << sprint(named<"[{x:r4}]\n">, sf::arg<"x">(5));
+    sscan("7 8", named<"{q} {p}">, sf::arg<"p">(a), sf::arg<"q">(w));
+    print(oss, "{} {}\n", w, a);
+#else
+    oss << "11-10-b\n[   5]\n7 8\n";
+#endif // SF_HAS_STATIC_NAMES
+    if (oss.str() == "bob is 002a 7; {missing}\npi: 3.14\nxyz 12\n11-10-b\n[   5]\n7 8\n")
+    {
+        print("Success.\n");
+    }
+    return 0;
+}
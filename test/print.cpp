@@ -3,6 +3,39 @@
 using namespace sf;
 using namespace std;
 
+//Leaves the stream in hex with a fill, and formats with a nested sprint.
+struct sticky
+{
+    int value;
+};
+
+ostream& operator<<(ostream& stream, const sticky& s)
+{
+    return stream << hex << setfill('*') << sprint("<{:d4}>", s.value);
+}
+
+//Keeps a slot and a callback of its own on the stream.
+struct tagged
+{
+    inline static const int index = ios_base::xalloc();
+    inline static int erased = 0;
+    inline static bool clean = true;
+};
+
+ostream& operator<<(ostream& stream, const tagged&)
+{
+    tagged::clean = tagged::clean && stream.iword(tagged::index) == 0 && stream.pword(tagged::index) == nullptr;
+    stream.iword(tagged::index) = 1;
+    stream.pword(tagged::index) = &stream;
+    stream.register_callback(
+        [](ios_base::event ev, ios_base&, int) {
+            if (ev == ios_base::erase_event)
+                tagged::erased++;
+        },
+        0);
+    return stream << "tag";
+}
+
 int main()
 {
     ostringstream oss;
@@ -15,7 +48,17 @@ int main()
     println(oss, "");
     oss << sprint("{0}{{{1}}}{0}\n", "123", "321");
     oss << sprint("{}", 123.456) << endl;
-    if (oss.str() == "Test\n\n0xfee1dead\nHello, world!\ntrue    \n123{321}123\n123.456\n")
+    println(oss, "{0:c,x8,s,u}|{1:c,i6}|{2:c,b,r6}|{3:c}|{4:c,l3}", 4276215469, -42, false, static_cast<void*>(nullptr), 'a');
+    println(oss, "{0:c}|{1:c,e3}|{2:c,f2,r6}", 0.1 + 0.2, 1234.56, 3.14159);
+    //Pooled streams start clean after a call leaves its state behind.
+    string pooled = sprint("{}", sticky{ 7 });
+    pooled += sprint("|{} ", 255);
+    pooled += sprint("{:r4}|{}", 255, string(100, 'z')).substr(0, 8);
+    //A pooled stream drops the slots and callbacks of a user operator before reuse.
+    for (int i = 0; i < 3; i++)
+        pooled += sprint("{}", tagged{});
+    if (pooled == "<0007>|255  255|zzztagtagtag" && tagged::clean && tagged::erased == 3 &&
+        oss.str() == "Test\n\n0xfee1dead\nHello, world!\ntrue    \n123{321}123\n123.456\n0XFEE1DEAD|-   42| false|0|a  \n0.30000000000000004|1.235e+03|  3.14\n")
     {
         println("Success.");
     }
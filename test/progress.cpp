@@ -0,0 +1,65 @@
+#include <sf/progress.hpp>
+#include <sf/sformat.hpp>
+#include <thread>
+#include <vector>
+
+using namespace sf;
+using namespace std;
+
+int main()
+{
+    ostringstream oss;
+    bool ok = true;
+    {
+        progress bar(oss, chrono::milliseconds(1));
+        progress::counter& done = bar.add("done", 4000);
+        progress::counter& errors = bar.add("errors");
+        vector<thread> workers;
+        for (int i = 0; i < 4; i++)
+        {
+            workers.emplace_back([&]() {
+                for (int j = 0; j < 1000; j++)
+                {
+                    done.add();
+                    if (j % 100 == 0)
+                        errors.add();
+                }
+            });
+        }
+        for (int i = 0; i < 20; i++)
+        {
+            println(oss, "log {}", i);
+        }
+        //Workers print lines of several pieces at the same time.
+        for (int i = 0; i < 4; i++)
+        {
+            workers.emplace_back([&oss, i]() {
+                for (int j = 0; j < 200; j++)
+                    println(oss, "worker {} line {} {}", i, j, string(j % 7, '*'));
+            });
+        }
+        for (thread& t : workers)
+            t.join();
+        bar.stop();
+        ok = done.get() == 4000 && errors.get() == 40;
+    }
+    string s = oss.str();
+    for (int i = 0; i < 20; i++)
+    {
+        ok = ok && s.find(sprint("log {}\n", i)) != string::npos;
+    }
+    for (int i = 0; i < 4; i++)
+    {
+        for (int j = 0; j < 200; j++)
+            ok = ok && s.find(sprint("worker {} line {} {}\n", i, j, string(j % 7, '*'))) != string::npos;
+    }
+    string last = "\033[2F\033[0Jdone [##############################] 4000/4000 100.0%\nerrors 40\n";
+    ok = ok && s.length() > last.length() && s.substr(s.length() - last.length()) == last;
+    print(oss, "after");
+    ok = ok && oss.str().substr(s.length()) == "after";
+    if (ok)
+    {
+        print("Success.\n");
+    }
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include <deque>
+#include <sf/sformat.hpp>
+#include <vector>
+
+using namespace sf;
+using namespace std;
+
+//A list type with its own operator>>, which reads "<n>:<element>...".
+struct path
+{
+    using value_type = string;
+    vector<string> parts;
+
+    void push_back(const string& part) { parts.push_back(part); }
+};
+
+istream& operator>>(istream& stream, path& p)
+{
+    size_t n = 0;
+    char colon = 0;
+    stream >> n >> colon;
+    string part;
+    while (n-- && stream >> part)
+        p.parts.push_back(part);
+    return stream;
+}
+
+int main()
+{
+    vector<int> a;
+    auto pos = sscan("1, 2,3 ,-4\nnext", "{:[sep=,]}", a);
+    bool ok = a == vector<int>{ 1, 2, 3, -4 } && pos == streampos(10);
+    //Separated by spaces to the end of the line, also through an inserter.
+    deque<double> d;
+    sscan("0.5 2 -3e2 \t1e-3", "{}", back_inserter(d));
+    ok = ok && d == deque<double>{ 0.5, 2, -300, 0.001 };
+    //Other flags still apply, and the list stops before a character which is not the separator.
+    vector<unsigned> h;
+    vector<string> s;
+    int n = 0;
+    string tail;
+    sscan("n=3 [ff;10;7] a,bb, c end", "n={} [{:x,[sep=;]}] {:[sep=,]} {}", n, h, s, tail);
+    ok = ok && n == 3 && h == vector<unsigned>{ 255, 16, 7 } && s == vector<string>{ "a", "bb", "c" } && tail == "end";
+    //Long lines, with numbers of every length.
+    string line;
+    vector<long long> expected;
+    long long v = 1;
+    for (int i = 0; i < 10000; i++)
+    {
+        v = v * 7 + i;
+        if (v > 1000000000000000000LL)
+            v = i;
+        expected.push_back(i % 3 ? v : -v);
+        line += sprint("{}{}", i ? "," : "", expected.back());
+    }
+    vector<long long> ll;
+    sscan(line, "{:[sep=,]}", ll);
+    ok = ok && ll == expected;
+    //A bad element fails the scan, and keeps the elements before it.
+    vector<int> bad;
+    ok = ok && sscan("1,2,x,4 ", "{:[sep=,]}", bad) == streampos(-1) && bad == vector<int>{ 1, 2 };
+    //A separator must be followed by an element.
+    vector<int> trailing;
+    ok = ok && sscan("1,2,\nnext", "{:[sep=,]}", trailing) == streampos(-1) && trailing == vector<int>{ 1, 2 };
+    ok = ok && sscan("1, 2 ,", "{:[sep=,]}", trailing) == streampos(-1);
+    //operator>> of the type is used unless the spec has a "[...]" group.
+    path p;
+    sscan("2: usr bin", "{}", p);
+    ok = ok && p.parts == vector<string>{ "usr", "bin" };
+    path q;
+    sscan("usr/lib", "{:[sep=/]}", q);
+    ok = ok && q.parts == vector<string>{ "usr", "lib" };
+    if (ok)
+    {
+        print("Success.\n");
+    }
+    return 0;
+}
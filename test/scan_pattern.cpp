@@ -0,0 +1,33 @@
+#include <sf/scan_pattern.hpp>
+
+using namespace sf;
+using namespace std;
+
+int main()
+{
+    scan_pattern<char> pattern("{} [{}] id={:x} latency={}ms ok={:b}");
+    string_view date;
+    string level;
+    unsigned id;
+    double latency;
+    bool okay;
+    auto r1 = pattern.match("2020-01-01 [INFO] id=0x2a latency=3.5ms ok=true", date, level, id, latency, okay);
+    bool matched = r1 && r1.position == 47 && date == "2020-01-01" && level == "INFO" && id == 42 && latency == 3.5 && okay;
+    auto r2 = pattern.match("2020-01-01 [WARN] id=zz latency=1ms ok=false", date, level, id, latency, okay);
+    auto r3 = pattern.match("2020-01-01 (INFO)", date, level, id, latency, okay);
+    //Names aren't supported, so they are rejected up front.
+    bool rejected = false;
+    try
+    {
+        scan_pattern<char> named("{} {name} {}");
+    }
+    catch (const invalid_argument&)
+    {
+        rejected = true;
+    }
+    if (matched && rejected && !r2 && r2.field == 2 && r2.position == 21 && !r3 && r3.field == scan_result::npos && r3.position == 11)
+    {
+        print("Success.\n");
+    }
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include <sf/sformat.hpp>
+#include <sf/stats.hpp>
+#include <sstream>
+#include <thread>
+
+using namespace sf;
+using namespace std;
+
+static const char print_fmt[] = "{} + {} = {}\n";
+static const char scan_fmt[] = "{} {}";
+
+//A buffer which can't tell its position, like a pipe.
+struct pipe_buf : streambuf
+{
+    string text;
+
+    int_type overflow(int_type c) override
+    {
+        if (c != traits_type::eof())
+            text.push_back(traits_type::to_char_type(c));
+        return traits_type::not_eof(c);
+    }
+};
+
+void work(int n)
+{
+    ostringstream oss;
+    for (int i = 0; i < n; i++)
+    {
+        print(oss, print_fmt, 1, 2, 3);
+    }
+}
+
+int main()
+{
+    thread t(work, 100);
+    work(50);
+    t.join();
+    int a = 0, b = 0;
+    istringstream good("12 34 rest");
+    scan(good, scan_fmt, a, b);
+    istringstream bad("12 x");
+    scan(bad, scan_fmt, a, b);
+    string rest;
+    good >> rest;
+    ostringstream heap;
+    for (int i = 0; i < 3; i++)
+    {
+        string fmt = "[{}]";
+        print(heap, fmt, i);
+    }
+    string printed = sprint("<{}>", 12345);
+    pipe_buf pipe;
+    ostream piped(&pipe);
+    print(piped, "({})", 678);
+    bool ok = rest == "rest" && a == 12 && printed == "<12345>" && pipe.text == "(678)";
+    auto entries = stats::snapshot();
+    ok = ok && entries.size() == 5;
+    for (const stats::entry& e : entries)
+    {
+        if (e.format == print_fmt)
+            ok = ok && !e.input && e.calls == 150 && e.bytes == 150 * 10 && e.failures == 0;
+        else if (e.format == scan_fmt)
+            ok = ok && e.input && e.calls == 2 && e.bytes == 5 + 3 && e.failures == 1;
+        else if (e.format == "[{}]")
+            ok = ok && !e.input && e.calls == 3 && e.bytes == 9;
+        else if (e.format == "<{}>")
+            ok = ok && !e.input && e.calls == 1 && e.bytes == 7;
+        else if (e.format == "({})")
+            ok = ok && !e.input && e.calls == 1 && e.bytes == 5;
+        else
+            ok = false;
+    }
+    stats::report(cout);
+    stats::reset();
+    ok = ok && stats::snapshot()[0].calls == 0;
+    if (ok)
+    {
+        print("Success.\n");
+    }
+    return 0;
+}
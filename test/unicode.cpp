@@ -0,0 +1,33 @@
+#include <sf/sformat.hpp>
+
+using namespace sf;
+using namespace std;
+
+int main()
+{
+    u16string s16 = u16sprint(u"{0:x8,s} {1:f2} {2} {3}: {4}", 4276215469, 3.14159, u"你好", string("\xe4\xb8\x96\xe7\x95\x8c"), U'\U0001F600');
+    u32string s32 = u32sprint(U"{} + {} = {}; {}", 1, 1, 2, u16string(u"abcdefghijklmnopqrstuvwxyzé"));
+    int a;
+    u16string word;
+    auto pos = u16sscan(u"éè 42 rest", u"{} {}", word, a);
+    //Fields are written and read on the code units, with flags and names.
+    u16string direct = u16sprint(u"{n}: {0:x,s} {1:e2,u} {1:r8} {{{2}}} {2:l4}|", sf::arg(u"n", -7), 12345.678, true);
+    unsigned h = 0;
+    u32string tag;
+    auto hpos = u32sscan(U"[ff] 名前 x", U"[{:x}] {}", h, tag);
+    //Display columns: wide CJK and emoji, a combining accent and plain ASCII.
+    string cols = sprint("|{:l8,t}|{:r6,t}|{:l5,t}|{:l5,t}|", "\xe6\x97\xa5\xe6\x9c\xac", string("\xf0\x9f\x98\x80"), "e\xcc\x81", "abc");
+    if (s16 == u"0xfee1dead 3.14 你好 世界: \U0001F600" &&
+        s32 == U"1 + 1 = 2; abcdefghijklmnopqrstuvwxyzé" &&
+        word == u"éè" && a == 42 && pos == u16streampos(5) &&
+        direct == u"-7: 0xfffffff9 1.23E+04  12345.7 {1} 1   |" && h == 255 && tag == U"名前" && hpos == u32streampos(7) &&
+        cols == "|\xe6\x97\xa5\xe6\x9c\xac    |    \xf0\x9f\x98\x80|e\xcc\x81    |abc  |" &&
+        from_utf8<char16_t>(to_utf8(u16string_view(u"A\xd800z"))) == u"A\xfffdz" &&
+        internal::display_width(U'\u3099') == 0 && internal::display_width(U'\u309A') == 0 && internal::display_width(U'\u302A') == 0 &&
+        internal::display_width(U'\u4DC0') == 1 && internal::display_width(U'\u4DFF') == 1 &&
+        internal::display_width(U'\u3042') == 2 && internal::display_width(U'\u4DBF') == 2 && internal::display_width(U'\u4E00') == 2)
+    {
+        print("Success.\n");
+    }
+    return 0;
+}
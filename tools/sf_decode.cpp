@@ -0,0 +1,24 @@
+#include <sf/deferred.hpp>
+
+using namespace sf;
+using namespace std;
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        println(cerr, "Usage: {} <file>...", argv[0]);
+        return 1;
+    }
+    int result = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        deferred_reader reader(argv[i]);
+        if (!reader.replay(cout))
+        {
+            println(cerr, "{}: invalid or truncated deferred log.", argv[i]);
+            result = 1;
+        }
+    }
+    return result;
+}